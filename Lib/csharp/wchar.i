@@ -14,7 +14,13 @@
 %insert(runtime) %{
 /* Callback for returning strings to C# without leaking memory */
 typedef void * (SWIGSTDCALL* SWIG_CSharpWStringHelperCallback)(const wchar_t *);
-static SWIG_CSharpWStringHelperCallback SWIG_csharp_wstring_callback = NULL;
+#if defined(SWIG_OUTSHARDS)
+# define SWIG_csharp_wstring_callback SWIG_csharp_wstring_callback_$module
+extern SWIG_CSharpWStringHelperCallback SWIG_csharp_wstring_callback;
+#endif
+#if !defined(SWIG_OUTSHARDS) || defined(SWIG_OUTSHARD_PRIMARY)
+SWIGCSHARPSTATE SWIG_CSharpWStringHelperCallback SWIG_csharp_wstring_callback = NULL;
+#endif
 %}
 
 %pragma(csharp) imclasscode=%{
@@ -42,12 +48,14 @@ static SWIG_CSharpWStringHelperCallback SWIG_csharp_wstring_callback = NULL;
 %}
 
 %insert(runtime) %{
+#if !defined(SWIG_OUTSHARDS) || defined(SWIG_OUTSHARD_PRIMARY)
 #ifdef __cplusplus
 extern "C"
 #endif
 SWIGEXPORT void SWIGSTDCALL SWIGRegisterWStringCallback_$module(SWIG_CSharpWStringHelperCallback callback) {
   SWIG_csharp_wstring_callback = callback;
 }
+#endif
 %}
 #endif // SWIG_CSHARP_WSTRING_HELPER_
 #endif // SWIG_CSHARP_NO_WSTRING_HELPER
@@ -425,22 +425,20 @@ typedef enum { ExactNoMatch = -2, PartiallySpecializedNoMatch = -1, PartiallySpe
  * does_parm_match()
  *
  * Template argument deduction - check if a template type matches a partially specialized 
- * template parameter type. Typedef reduce 'partial_parm_type' to see if it matches 'type'.
+ * template parameter type. Typedef reduce 'partial_parm_type' to see if it matches 'ty'.
  *
- * type - template parameter type to match against
+ * ty - template parameter type to match against, already typedef reduced in the template scope
  * partial_parm_type - partially specialized template type - a possible match
  * partial_parm_type_base - base type of partial_parm_type
- * tscope - template scope
  * specialization_priority - (output) contains a value indicating how good the match is 
  *   (higher is better) only set if return is set to PartiallySpecializedMatch or ExactMatch.
  * ----------------------------------------------------------------------------- */
 
-static EMatch does_parm_match(SwigType *type, SwigType *partial_parm_type, const char *partial_parm_type_base, Symtab *tscope, int *specialization_priority) {
+static EMatch does_parm_match(SwigType *ty, SwigType *partial_parm_type, const char *partial_parm_type_base, int *specialization_priority) {
   static const int EXACT_MATCH_PRIORITY = 99999; /* a number bigger than the length of any conceivable type */
   int matches;
   int substitutions;
   EMatch match;
-  SwigType *ty = Swig_symbol_typedef_reduce(type, tscope);
   String *base = SwigType_base(ty);
   SwigType *t = Copy(partial_parm_type);
   substitutions = Replaceid(t, partial_parm_type_base, base); /* eg: Replaceid("p.$1", "$1", "int") returns t="p.int" */
@@ -475,14 +473,129 @@ static EMatch does_parm_match(SwigType *type, SwigType *partial_parm_type, const
       *specialization_priority = EXACT_MATCH_PRIORITY; /* exact matches always take precedence */
   }
   /*
-  Printf(stdout, "      does_parm_match %2d %5d [%s] [%s]\n", match, *specialization_priority, type, partial_parm_type);
+  Printf(stdout, "      does_parm_match %2d %5d [%s] [%s]\n", match, *specialization_priority, ty, partial_parm_type);
   */
   Delete(t);
   Delete(base);
-  Delete(ty);
   return match;
 }
 
+/* -----------------------------------------------------------------------------
+ * partial_parm_shape()
+ *
+ * Classifies a template argument type by its leading type constructor, such as
+ * "p" for a pointer or "q" for a qualifier, or "-" for a plain type.  A partially
+ * specialized parameter type can only match a type of the same shape unless it
+ * starts with a template parameter ($1, $2...), in which case 0 is returned.
+ * ----------------------------------------------------------------------------- */
+
+static const char *partial_parm_shape(const SwigType *t, char *shape) {
+  const char *c = Char(t);
+  if (!c || c[0] == '$')
+    return 0;
+  shape[0] = (c[0] && (c[1] == '.' || c[1] == '(')) ? c[0] : '-';
+  shape[1] = 0;
+  return shape;
+}
+
+/* -----------------------------------------------------------------------------
+ * template_data()
+ *
+ * Returns a hash for the lookup data kept for a primary template, the partial
+ * specialization index and the template_locate() results.  It is kept here
+ * rather than as attributes of the template node, as copy_node() would copy
+ * those into every instantiation.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *template_data_cache = 0;
+
+static Hash *template_data(Node *templ) {
+  String *key = NewStringf("%p", templ);
+  Hash *data;
+  if (!template_data_cache)
+    template_data_cache = NewHash();
+  data = Getattr(template_data_cache, key);
+  if (!data) {
+    data = NewHash();
+    Setattr(template_data_cache, key, data);
+    Delete(data);
+  }
+  Delete(key);
+  return data;
+}
+
+/* -----------------------------------------------------------------------------
+ * partials_index()
+ *
+ * Returns the partial specializations of a primary template indexed by number of
+ * parameters and then by the shape of the first parameter.  Each list keeps the
+ * declaration order.  "*" lists all the partials with that number of parameters
+ * and "?" only those whose first parameter matches any shape.  The index is
+ * rebuilt when more partial specializations are declared.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *partials_index(Node *templ) {
+  char shapebuf[2];
+  Iterator pi;
+  List *partials = Getattr(templ, "partials");
+  Hash *data = template_data(templ);
+  Hash *index = Getattr(data, "partialsindex");
+  if (!partials)
+    return 0;
+  if (index && GetInt(index, "count") == Len(partials))
+    return index;
+
+  index = NewHash();
+  SetInt(index, "count", Len(partials));
+  Setattr(data, "partialsindex", index);
+  Delete(index);
+
+  /* Create the lists for each number of parameters and first parameter shape */
+  for (pi = First(partials); pi.item; pi = Next(pi)) {
+    Parm *partialparms = Getattr(pi.item, "partialparms");
+    String *arity = NewStringf("%d", ParmList_len(partialparms));
+    Hash *shapes = Getattr(index, arity);
+    const char *shape = partialparms ? partial_parm_shape(Getattr(partialparms, "type"), shapebuf) : 0;
+    if (!shapes) {
+      List *all = NewList();
+      List *any = NewList();
+      shapes = NewHash();
+      Setattr(shapes, "*", all);
+      Setattr(shapes, "?", any);
+      Setattr(index, arity, shapes);
+      Delete(any);
+      Delete(all);
+      Delete(shapes);
+    }
+    if (shape && !Getattr(shapes, shape)) {
+      List *l = NewList();
+      Setattr(shapes, shape, l);
+      Delete(l);
+    }
+    Delete(arity);
+  }
+
+  /* Fill them in declaration order */
+  for (pi = First(partials); pi.item; pi = Next(pi)) {
+    Parm *partialparms = Getattr(pi.item, "partialparms");
+    String *arity = NewStringf("%d", ParmList_len(partialparms));
+    Hash *shapes = Getattr(index, arity);
+    const char *shape = partialparms ? partial_parm_shape(Getattr(partialparms, "type"), shapebuf) : 0;
+    Append(Getattr(shapes, "*"), pi.item);
+    if (shape) {
+      Append(Getattr(shapes, shape), pi.item);
+    } else {
+      Iterator si;
+      for (si = First(shapes); si.key; si = Next(si)) {
+	if (!Equal(si.key, "*"))
+	  Append(si.item, pi.item);
+      }
+    }
+    Delete(arity);
+  }
+  return index;
+}
+
 /* -----------------------------------------------------------------------------
  * template_locate()
  *
@@ -502,6 +615,7 @@ static Node *template_locate(String *name, Parm *tparms, Symtab *tscope) {
   int *priorities_matrix = 0;
   int max_possible_partials = 0;
   int posslen = 0;
+  int cacheable = 0;
 
   /* Search for primary (unspecialized) template */
   templ = Swig_symbol_clookup(name, 0);
@@ -539,6 +653,18 @@ static Node *template_locate(String *name, Parm *tparms, Symtab *tscope) {
     }
     SwigType_add_template(tname, expandedparms);
 
+    /* A previous search for the same template arguments from the same scope finds
+       the same template for as long as the symbol tables are unchanged */
+    if (!template_debug && tscope) {
+      Hash *cache = Getattr(template_data(templ), "locatecache");
+      Hash *found = cache ? Getattr(cache, tname) : 0;
+      if (found && Getattr(found, "tscope") == tscope && GetInt(found, "generation") == Swig_symbol_lookup_generation()) {
+	n = Getattr(found, "node");
+	goto success;
+      }
+      cacheable = 1;
+    }
+
     /* Search for an explicit (exact) specialization. Example: template<> class name<int> { ... } */
     {
       if (template_debug) {
@@ -593,50 +719,66 @@ static Node *template_locate(String *name, Parm *tparms, Symtab *tscope) {
     possiblepartials = NewList();
     {
       char tmp[32];
-      List *partials;
-
-      partials = Getattr(templ, "partials"); /* note that these partial specializations do not include explicit specializations */
-      if (partials) {
+      Hash *index = partials_index(templ); /* note that these partial specializations do not include explicit specializations */
+      int parms_len = ParmList_len(parms);
+      String *arity = NewStringf("%d", parms_len);
+      Hash *shapes = index ? Getattr(index, arity) : 0;
+      Delete(arity);
+      if (shapes && parms_len > 0) {
 	Iterator pi;
-	int parms_len = ParmList_len(parms);
+	List *partials;
+	SwigType **reduced_parms = (SwigType **)malloc(sizeof(SwigType *) * parms_len);
 	int *priorities_row;
+	int i;
+
+	/* Typedef reduce the template parameters once, rather than for every partial specialization */
+	for (p = parms, i = 0; p; p = nextSibling(p), i++) {
+	  SwigType *t = Getattr(p, "type");
+	  if (!t)
+	    t = Getattr(p, "value");
+	  reduced_parms[i] = t ? Swig_symbol_typedef_reduce(t, tscope) : 0;
+	}
+
+	/* Only the partial specializations whose first parameter can match need checking */
+	if (reduced_parms[0]) {
+	  char shape[2];
+	  partials = Getattr(shapes, partial_parm_shape(reduced_parms[0], shape));
+	  if (!partials)
+	    partials = Getattr(shapes, "?");
+	} else {
+	  partials = Getattr(shapes, "*");
+	}
+
 	max_possible_partials = Len(partials);
 	priorities_matrix = (int *)malloc(sizeof(int) * max_possible_partials * parms_len); /* slightly wasteful allocation for max possible matches */
 	priorities_row = priorities_matrix;
 	for (pi = First(partials); pi.item; pi = Next(pi)) {
-	  Parm *p = parms;
 	  int all_parameters_match = 1;
-	  int i = 1;
-	  Parm *partialparms = Getattr(pi.item, "partialparms");
-	  Parm *pp = partialparms;
+	  Parm *pp = Getattr(pi.item, "partialparms");
 	  String *templcsymname = Getattr(pi.item, "templcsymname");
 	  if (template_debug) {
 	    Printf(stdout, "    checking match: '%s' (partial specialization)\n", templcsymname);
 	  }
-	  if (ParmList_len(partialparms) == parms_len) {
-	    while (p && pp) {
-	      SwigType *t;
-	      sprintf(tmp, "$%d", i);
-	      t = Getattr(p, "type");
-	      if (!t)
-		t = Getattr(p, "value");
-	      if (t) {
-		EMatch match = does_parm_match(t, Getattr(pp, "type"), tmp, tscope, priorities_row + i - 1);
-		if (match < (int)PartiallySpecializedMatch) {
-		  all_parameters_match = 0;
-		  break;
-		}
+	  for (i = 0; i < parms_len && pp; i++, pp = nextSibling(pp)) {
+	    if (reduced_parms[i]) {
+	      EMatch match;
+	      sprintf(tmp, "$%d", i + 1);
+	      match = does_parm_match(reduced_parms[i], Getattr(pp, "type"), tmp, priorities_row + i);
+	      if (match < (int)PartiallySpecializedMatch) {
+		all_parameters_match = 0;
+		break;
 	      }
-	      i++;
-	      p = nextSibling(p);
-	      pp = nextSibling(pp);
-	    }
-	    if (all_parameters_match) {
-	      Append(possiblepartials, pi.item);
-	      priorities_row += parms_len;
 	    }
 	  }
+	  if (all_parameters_match) {
+	    Append(possiblepartials, pi.item);
+	    priorities_row += parms_len;
+	  }
 	}
+
+	for (i = 0; i < parms_len; i++)
+	  Delete(reduced_parms[i]);
+	free(reduced_parms);
       }
     }
 
@@ -752,6 +894,7 @@ static Node *template_locate(String *name, Parm *tparms, Symtab *tscope) {
       n = Swig_symbol_clookup_local(s, primary_scope);
       if (posslen > 1) {
 	int i;
+	cacheable = 0; /* so that the ambiguity warnings are repeated */
 	if (n) {
 	  Swig_warning(WARN_PARSE_TEMPLATE_AMBIG, cparse_file, cparse_line, "Instantiation of template '%s' is ambiguous,\n", SwigType_namestr(tname));
 	  Swig_warning(WARN_PARSE_TEMPLATE_AMBIG, Getfile(n), Getline(n), "  instantiation '%s' used,\n", SwigType_namestr(Getattr(n, "name")));
@@ -789,6 +932,21 @@ static Node *template_locate(String *name, Parm *tparms, Symtab *tscope) {
     }
   }
 success:
+  if (n && cacheable) {
+    Hash *data = template_data(templ);
+    Hash *cache = Getattr(data, "locatecache");
+    Hash *found = NewHash();
+    if (!cache) {
+      cache = NewHash();
+      Setattr(data, "locatecache", cache);
+      Delete(cache);
+    }
+    Setattr(found, "node", n);
+    Setattr(found, "tscope", tscope);
+    SetInt(found, "generation", Swig_symbol_lookup_generation());
+    Setattr(cache, tname, found);
+    Delete(found);
+  }
   Delete(tname);
   Delete(possiblepartials);
   if ((template_debug) && (n)) {
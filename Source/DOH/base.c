@@ -810,6 +810,22 @@ int DohReplace(DOH *src, const DOH *token, const DOH *rep, int flags) {
   return 0;
 }
 
+/* -----------------------------------------------------------------------------
+ * DohReplaceMulti()
+ * ----------------------------------------------------------------------------- */
+
+int DohReplaceMulti(DOH *src, DohReplaceItem *items, int nitems) {
+  DohBase *b = (DohBase *) src;
+  DohObjInfo *objinfo;
+  if (DohIsString(src)) {
+    objinfo = b->type;
+    if (objinfo->doh_string->doh_replacemulti) {
+      return (objinfo->doh_string->doh_replacemulti) (b, items, nitems);
+    }
+  }
+  return 0;
+}
+
 /* -----------------------------------------------------------------------------
  * DohChop()
  * ----------------------------------------------------------------------------- */
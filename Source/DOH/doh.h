@@ -78,6 +78,8 @@
 #define DohGetfile         DOH_NAMESPACE(Getfile)
 #define DohSetfile         DOH_NAMESPACE(Setfile)
 #define DohReplace         DOH_NAMESPACE(Replace)
+#define DohReplaceMulti    DOH_NAMESPACE(ReplaceMulti)
+#define DohReplaceItem     DOH_NAMESPACE(ReplaceItem)
 #define DohChop            DOH_NAMESPACE(Chop)
 #define DohGetmeta         DOH_NAMESPACE(Getmeta)
 #define DohSetmeta         DOH_NAMESPACE(Setmeta)
@@ -103,10 +105,14 @@
 #define DohNewFileFromFile DOH_NAMESPACE(NewFileFromFile)
 #define DohNewFileFromFd   DOH_NAMESPACE(NewFileFromFd)
 #define DohFileErrorDisplay   DOH_NAMESPACE(FileErrorDisplay)
+#define DohFileWriteIfChanged DOH_NAMESPACE(FileWriteIfChanged)
+#define DohFileCommitPending DOH_NAMESPACE(FileCommitPending)
+#define DohFileStatistics  DOH_NAMESPACE(FileStatistics)
 #define DohClose           DOH_NAMESPACE(Close)
 #define DohCopyto          DOH_NAMESPACE(Copyto)
 #define DohNewList         DOH_NAMESPACE(NewList)
 #define DohNewHash         DOH_NAMESPACE(NewHash)
+#define DohNewChainedHash  DOH_NAMESPACE(NewChainedHash)
 #define DohNewVoid         DOH_NAMESPACE(NewVoid)
 #define DohSplit           DOH_NAMESPACE(Split)
 #define DohSplitLines      DOH_NAMESPACE(SplitLines)
@@ -115,6 +121,9 @@
 #define DohObjMalloc       DOH_NAMESPACE(ObjMalloc)
 #define DohObjFree         DOH_NAMESPACE(ObjFree)
 #define DohMemoryDebug     DOH_NAMESPACE(MemoryDebug)
+#define DohCountMalloc     DOH_NAMESPACE(CountMalloc)
+#define DohCountRealloc    DOH_NAMESPACE(CountRealloc)
+#define DohMemoryStatistics DOH_NAMESPACE(MemoryStatistics)
 #define DohStringType      DOH_NAMESPACE(StringType)
 #define DohListType        DOH_NAMESPACE(ListType)
 #define DohHashType        DOH_NAMESPACE(HashType)
@@ -165,15 +174,18 @@ typedef struct {
 /* Memory management */
 
 #ifndef DohMalloc
-#define DohMalloc malloc
+#define DohMalloc DohCountMalloc
 #endif
 #ifndef DohRealloc
-#define DohRealloc realloc
+#define DohRealloc DohCountRealloc
 #endif
 #ifndef DohFree
 #define DohFree free
 #endif
 
+extern void *DohCountMalloc(size_t size);
+extern void *DohCountRealloc(void *ptr, size_t size);
+
 extern int DohCheck(const DOH *ptr);	/* Check if a DOH object */
 extern void DohIntern(DOH *);	/* Intern an object      */
 
@@ -299,6 +311,17 @@ extern char *DohStrchr(const DOHString_or_char *s1, int ch);
 #define Replaceall(s,t,r)  DohReplace(s,t,r,DOH_REPLACE_ANY)
 #define Replaceid(s,t,r)   DohReplace(s,t,r,DOH_REPLACE_ID)
 
+/* Multiple token replacement (see DohReplaceMulti) */
+
+typedef struct {
+  const char *token;		/* Token to replace              */
+  const DOHString_or_char *rep;	/* Replacement text              */
+  int flags;			/* DOH_REPLACE_* flags           */
+  int count;			/* Number of replacements made   */
+} DohReplaceItem;
+
+extern int DohReplaceMulti(DOHString * src, DohReplaceItem *items, int nitems);
+
 /* -----------------------------------------------------------------------------
  * Files
  * ----------------------------------------------------------------------------- */
@@ -307,6 +330,9 @@ extern DOHFile *DohNewFile(DOH *filename, const char *mode, DOHList *outfiles);
 extern DOHFile *DohNewFileFromFile(FILE *f);
 extern DOHFile *DohNewFileFromFd(int fd);
 extern void DohFileErrorDisplay(DOHString * filename);
+extern void DohFileWriteIfChanged(int enable);
+extern void DohFileCommitPending(void);
+extern void DohFileStatistics(int *changed, int *unchanged);
 /*
  Deprecated, just use DohDelete
 extern int DohClose(DOH *file);
@@ -326,6 +352,7 @@ extern void DohSortList(DOH *lo, int (*cmp) (const DOH *, const DOH *));
  * ----------------------------------------------------------------------------- */
 
 extern DOHHash *DohNewHash(void);
+extern DOHHash *DohNewChainedHash(void);
 
 /* -----------------------------------------------------------------------------
  * Void
@@ -337,6 +364,7 @@ extern DOHList *DohSplitLines(DOHFile * input);
 extern DOH *DohNone;
 
 extern void DohMemoryDebug(void);
+extern void DohMemoryStatistics(unsigned long *objects, unsigned long *bytes);
 
 #ifndef DOH_LONG_NAMES
 /* Macros to invoke the above functions.  Includes the location of
@@ -404,6 +432,8 @@ extern void DohMemoryDebug(void);
 #define ClearFlag(o,n)     DohSetFlagAttr(o,n,"")
 #define Readline           DohReadline
 #define Replace            DohReplace
+#define ReplaceMulti       DohReplaceMulti
+#define ReplaceItem        DohReplaceItem
 #define Chop               DohChop
 #define Getmeta            DohGetmeta
 #define Setmeta            DohSetmeta
@@ -413,6 +443,7 @@ extern void DohMemoryDebug(void);
 #define NewStringWithSize  DohNewStringWithSize
 #define NewStringf         DohNewStringf
 #define NewHash            DohNewHash
+#define NewChainedHash     DohNewChainedHash
 #define NewList            DohNewList
 #define NewFile            DohNewFile
 #define NewFileFromFile    DohNewFileFromFile
@@ -56,6 +56,7 @@ typedef struct {
 typedef struct {
   int (*doh_replace) (DOH *obj, const DOHString_or_char *old, const DOHString_or_char *rep, int flags);
   void (*doh_chop) (DOH *obj);
+  int (*doh_replacemulti) (DOH *obj, DohReplaceItem *items, int nitems);
 } DohStringMethods;
 
 /* -----------------------------------------------------------------------------
@@ -128,5 +129,6 @@ typedef struct {
 
 extern DOH *DohObjMalloc(DohObjInfo *type, void *data);	/* Allocate a DOH object */
 extern void DohObjFree(DOH *ptr);	/* Free a DOH object     */
+extern void DohHashStatistics(DOH *ho, int *nitems, int *nslots, int *nsmall, int *ndisplaced, int *maxprobe);
 
 #endif				/* DOHINT_H */
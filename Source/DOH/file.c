@@ -19,18 +19,98 @@
 #endif
 #include <errno.h>
 
-typedef struct {
+typedef struct DohFile {
   FILE *filep;
   int fd;
   int closeondel;
+  DOH *buffer;			/* Contents held back in write-if-changed mode */
+  DOH *filename;
+  int binary;
+  struct DohFile *next;		/* Next file still to be written out */
 } DohFile;
 
+static int write_if_changed = 0;
+static int files_changed = 0;
+static int files_unchanged = 0;
+static DohFile *pending_files = 0;
+
+/* -----------------------------------------------------------------------------
+ * File_commit()
+ *
+ * Writes out a file opened in write-if-changed mode.  The file on disk is only
+ * replaced, by renaming a temporary file over it, if its contents differ.
+ * ----------------------------------------------------------------------------- */
+
+static int File_commit(DohFile *f) {
+  DohFile **p;
+  FILE *old;
+  const char *name = Char(f->filename);
+  const char *data = Char(f->buffer);
+  int len = Len(f->buffer);
+  int same = 0;
+  int ret = 0;
+
+  for (p = &pending_files; *p; p = &(*p)->next) {
+    if (*p == f) {
+      *p = f->next;
+      break;
+    }
+  }
+
+  old = fopen(name, f->binary ? "rb" : "r");
+  if (old) {
+    char chunk[8192];
+    size_t n;
+    int pos = 0;
+    same = 1;
+    while (same && (n = fread(chunk, 1, sizeof(chunk), old)) > 0) {
+      if (pos + (int) n > len || memcmp(chunk, data + pos, n) != 0)
+	same = 0;
+      pos += (int) n;
+    }
+    if (pos != len)
+      same = 0;
+    fclose(old);
+  }
+
+  if (same) {
+    files_unchanged++;
+  } else {
+    DOH *tmpname = NewStringf("%s.swigtmp", f->filename);
+    FILE *tmp = fopen(Char(tmpname), f->binary ? "wb" : "w");
+    if (!tmp || fwrite(data, 1, len, tmp) != (size_t) len)
+      ret = -1;
+    if (tmp && fclose(tmp) != 0)
+      ret = -1;
+#ifdef _WIN32
+    if (ret == 0)
+      remove(name);
+#endif
+    if (ret == 0 && rename(Char(tmpname), name) != 0)
+      ret = -1;
+    if (ret != 0) {
+      Printf(stderr, "Unable to write file %s: %s\n", f->filename, strerror(errno));
+      remove(Char(tmpname));
+    }
+    files_changed++;
+    Delete(tmpname);
+  }
+  Delete(f->buffer);
+  f->buffer = 0;
+  Delete(f->filename);
+  f->filename = 0;
+  return ret;
+}
+
+
 /* -----------------------------------------------------------------------------
  * DelFile()
  * ----------------------------------------------------------------------------- */
 
 static void DelFile(DOH *fo) {
   DohFile *f = (DohFile *) ObjData(fo);
+  if (f->buffer)
+    File_commit(f);
   if (f->closeondel) {
     if (f->filep) {
       fclose(f->filep);
@@ -67,7 +147,9 @@ static int File_read(DOH *fo, void *buffer, int len) {
 
 static int File_write(DOH *fo, const void *buffer, int len) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return Write(f->buffer, buffer, len);
+  } else if (f->filep) {
     int ret = (int) fwrite(buffer, 1, len, f->filep);
     int err = (ret != len) ? ferror(f->filep) : 0;
     return err ? -1 : ret;
@@ -85,7 +167,9 @@ static int File_write(DOH *fo, const void *buffer, int len) {
 
 static int File_seek(DOH *fo, long offset, int whence) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return Seek(f->buffer, offset, whence);
+  } else if (f->filep) {
     return fseek(f->filep, offset, whence);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -101,7 +185,9 @@ static int File_seek(DOH *fo, long offset, int whence) {
 
 static long File_tell(DOH *fo) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return Tell(f->buffer);
+  } else if (f->filep) {
     return ftell(f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -117,7 +203,9 @@ static long File_tell(DOH *fo) {
 
 static int File_putc(DOH *fo, int ch) {
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    return Putc(ch, f->buffer);
+  } else if (f->filep) {
     return fputc(ch, f->filep);
   } else if (f->fd) {
 #ifdef DOH_INTFILE
@@ -175,7 +263,9 @@ static int File_ungetc(DOH *fo, int ch) {
 static int File_close(DOH *fo) {
   int ret = 0;
   DohFile *f = (DohFile *) ObjData(fo);
-  if (f->filep) {
+  if (f->buffer) {
+    ret = File_commit(f);
+  } else if (f->filep) {
     ret = fclose(f->filep);
     f->filep = 0;
   } else if (f->fd) {
@@ -229,21 +319,30 @@ static DohObjInfo DohFileType = {
  *
  * Create a new file from a given filename and mode.
  * If newfiles is non-zero, the filename is added to the list of new files.
+ * In write-if-changed mode a file opened for writing is held in memory until
+ * it is closed or deleted, see File_commit().
  * ----------------------------------------------------------------------------- */
 
 DOH *DohNewFile(DOH *filename, const char *mode, DOHList *newfiles) {
   DohFile *f;
   FILE *file;
   char *filen;
+  int buffered = write_if_changed && mode[0] == 'w' && !strchr(mode, '+');
 
   filen = Char(filename);
-  file = fopen(filen, mode);
+  /* In write-if-changed mode just check that the file can be written, without changing it */
+  file = fopen(filen, buffered ? "a" : mode);
   if (!file)
     return 0;
+  if (buffered) {
+    fclose(file);
+    file = 0;
+  }
 
   f = (DohFile *) DohMalloc(sizeof(DohFile));
   if (!f) {
-    fclose(file);
+    if (file)
+      fclose(file);
     return 0;
   }
   if (newfiles)
@@ -251,6 +350,17 @@ DOH *DohNewFile(DOH *filename, const char *mode, DOHList *newfiles) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 1;
+  f->buffer = 0;
+  f->filename = 0;
+  f->binary = 0;
+  f->next = 0;
+  if (buffered) {
+    f->buffer = NewStringEmpty();
+    f->filename = NewString(filename);
+    f->binary = strchr(mode, 'b') != 0;
+    f->next = pending_files;
+    pending_files = f;
+  }
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -268,6 +378,10 @@ DOH *DohNewFileFromFile(FILE *file) {
   f->filep = file;
   f->fd = 0;
   f->closeondel = 0;
+  f->buffer = 0;
+  f->filename = 0;
+  f->binary = 0;
+  f->next = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -285,6 +399,10 @@ DOH *DohNewFileFromFd(int fd) {
   f->filep = 0;
   f->fd = fd;
   f->closeondel = 0;
+  f->buffer = 0;
+  f->filename = 0;
+  f->binary = 0;
+  f->next = 0;
   return DohObjMalloc(&DohFileType, f);
 }
 
@@ -297,3 +415,46 @@ DOH *DohNewFileFromFd(int fd) {
 void DohFileErrorDisplay(DOHString * filename) {
   Printf(stderr, "Unable to open file %s: %s\n", filename, strerror(errno));
 }
+
+/* -----------------------------------------------------------------------------
+ * FileWriteIfChanged()
+ *
+ * Turns write-if-changed mode on or off for files subsequently opened for
+ * writing.  In this mode an existing file is left untouched, timestamp and all,
+ * when it would be rewritten with the same contents.
+ * ----------------------------------------------------------------------------- */
+
+void DohFileWriteIfChanged(int enable) {
+  static int registered = 0;
+  if (enable && !registered) {
+    atexit(DohFileCommitPending);
+    registered = 1;
+  }
+  write_if_changed = enable;
+}
+
+/* -----------------------------------------------------------------------------
+ * FileCommitPending()
+ *
+ * Writes out the files held back in write-if-changed mode that are still open,
+ * typically because they are still referenced.  Also done when SWIG exits.
+ * ----------------------------------------------------------------------------- */
+
+void DohFileCommitPending(void) {
+  while (pending_files)
+    File_commit(pending_files);
+}
+
+/* -----------------------------------------------------------------------------
+ * FileStatistics()
+ *
+ * Returns the number of files written in write-if-changed mode which were
+ * changed and which were left unchanged.
+ * ----------------------------------------------------------------------------- */
+
+void DohFileStatistics(int *changed, int *unchanged) {
+  if (changed)
+    *changed = files_changed;
+  if (unchanged)
+    *unchanged = files_unchanged;
+}
@@ -15,90 +15,236 @@
 
 extern DohObjInfo DohHashType;
 
-/* Hash node */
-typedef struct HashNode {
-  DOH *key;
+/* Hash entry */
+typedef struct HashEntry {
+  DOH *key;			/* 0 if the entry has been deleted */
   DOH *object;
-  struct HashNode *next;
-} HashNode;
+} HashEntry;
 
-/* Hash object */
+/* Hash object.  The entries are kept in insertion order, which is also the
+   iteration order, and deleted entries are squeezed out when the table grows.
+   The cached Hashval() of each key is kept in a separate array allocated
+   after the entries, so that searches only touch the entries that match. */
 typedef struct Hash {
   DOH *file;
   int line;
-  HashNode **hashtable;
-  int hashsize;
+  HashEntry *entries;
+  int *hashvals;
+  int nentries;			/* Entries in use, including deleted ones */
+  int maxentries;		/* Allocated entries */
+  int *index;			/* Position + 1 of the entry in each slot, 0 if empty */
+  int indexmask;		/* Number of slots - 1 */
   int nitems;
 } Hash;
 
+typedef int (*binop) (DOH *obj1, DOH *obj2);
+
 /* Key interning structure */
 typedef struct KeyValue {
   char *cstr;
   DOH *sstr;
-  struct KeyValue *left;
-  struct KeyValue *right;
+  unsigned int hashval;
 } KeyValue;
 
-static KeyValue *root = 0;
+/* Interned keys live in an open addressing table indexed by a hash of the
+   C string, so that Getattr(n, "name") and friends are a single probe in the
+   common case instead of a walk down a (frequently degenerate) binary tree. */
+static KeyValue *key_table = 0;
+static int key_table_size = 0;
+static int key_table_count = 0;
 static int max_expand = 1;
 
+#define KEY_TABLE_INIT_SIZE 1024
+
+/* Attribute names used all over the parse tree, interned up front */
+static const char *hot_keys[] = {
+  "name", "sym:name", "type", "decl", "nodeType", "parms", "storage", "value",
+  "kind", "code", "access", "parentNode", "firstChild", "lastChild", "nextSibling",
+  "previousSibling", "sym:symtab", "sym:overname", "sym:nextSibling", "feature:ignore",
+  "classname", "symtab", "csymtab", "template", "baselist", "wrap:name", "view", 0
+};
+
+static unsigned int key_hash(const char *c) {
+  unsigned int h = 2166136261U;
+  while (*c) {
+    h ^= (unsigned char) *(c++);
+    h *= 16777619U;
+  }
+  return h;
+}
+
+static void key_table_insert(KeyValue *kv) {
+  int mask = key_table_size - 1;
+  int i = (int) (kv->hashval & (unsigned int) mask);
+  while (key_table[i].cstr)
+    i = (i + 1) & mask;
+  key_table[i] = *kv;
+}
+
+static void key_table_resize(int newsize) {
+  KeyValue *oldtable = key_table;
+  int oldsize = key_table_size;
+  int i;
+  key_table = (KeyValue *) DohMalloc(newsize * sizeof(KeyValue));
+  memset(key_table, 0, newsize * sizeof(KeyValue));
+  key_table_size = newsize;
+  for (i = 0; i < oldsize; i++) {
+    if (oldtable[i].cstr)
+      key_table_insert(&oldtable[i]);
+  }
+  DohFree(oldtable);
+}
+
 /* Find or create a key in the interned key table */
 static DOH *find_key(DOH *doh_c) {
   char *c = (char *) doh_c;
-  KeyValue *r, *s;
-  int d = 0;
-  /* OK, sure, we use a binary tree for maintaining interned
-     symbols.  Then we use their hash values for accessing secondary
-     hash tables. */
-  r = root;
-  s = 0;
-  while (r) {
-    s = r;
-    d = strcmp(r->cstr, c);
-    if (d == 0)
-      return r->sstr;
-    if (d < 0)
-      r = r->left;
-    else
-      r = r->right;
+  KeyValue kv;
+  int i, mask;
+  unsigned int hv;
+
+  if (!key_table) {
+    const char **hk;
+    key_table_resize(KEY_TABLE_INIT_SIZE);
+    for (hk = hot_keys; *hk; hk++)
+      find_key((DOH *) *hk);
+  }
+
+  hv = key_hash(c);
+  mask = key_table_size - 1;
+  i = (int) (hv & (unsigned int) mask);
+  while (key_table[i].cstr) {
+    if ((key_table[i].hashval == hv) && (strcmp(key_table[i].cstr, c) == 0))
+      return key_table[i].sstr;
+    i = (i + 1) & mask;
   }
   /*  fprintf(stderr,"Interning '%s'\n", c); */
-  r = (KeyValue *) DohMalloc(sizeof(KeyValue));
-  r->cstr = (char *) DohMalloc(strlen(c) + 1);
-  strcpy(r->cstr, c);
-  r->sstr = NewString(c);
-  DohIntern(r->sstr);
-  r->left = 0;
-  r->right = 0;
-  if (!s) {
-    root = r;
+  kv.cstr = (char *) DohMalloc(strlen(c) + 1);
+  strcpy(kv.cstr, c);
+  kv.sstr = NewString(c);
+  DohIntern(kv.sstr);
+  kv.hashval = hv;
+  if ((key_table_count + 1) * 2 > key_table_size)
+    key_table_resize(key_table_size * 2);
+  key_table_insert(&kv);
+  key_table_count++;
+  return kv.sstr;
+}
+
+#define HASH_INIT_SIZE   8
+#define HASH_SMALL       16
+
+/* A table with no index is searched by a linear scan of the cached hash
+   values, which beats probing an index for the small attribute sets of most
+   parse tree nodes.  Once a table can hold more than HASH_SMALL entries an
+   open addressing index is added, at most half full and linearly probed. */
+
+/* Entry arrays of the initial size, which is all most tables ever need, are
+   recycled through a free list linked through the first key rather than being
+   returned to malloc */
+static HashEntry *entries_freelist = 0;
+
+static void NewEntries(Hash *h, int size) {
+  HashEntry *e;
+  if ((size == HASH_INIT_SIZE) && entries_freelist) {
+    e = entries_freelist;
+    entries_freelist = (HashEntry *) e->key;
   } else {
-    if (d < 0)
-      s->left = r;
-    else
-      s->right = r;
+    e = (HashEntry *) DohMalloc(size * (sizeof(HashEntry) + sizeof(int)));
+    assert(e);
   }
-  return r->sstr;
+  h->entries = e;
+  h->hashvals = (int *) (e + size);
+  h->maxentries = size;
 }
 
-#define HASH_INIT_SIZE   7
+static void DelEntries(Hash *h) {
+  if (!h->entries)
+    return;
+  if (h->maxentries == HASH_INIT_SIZE) {
+    h->entries->key = (DOH *) entries_freelist;
+    entries_freelist = h->entries;
+  } else {
+    DohFree(h->entries);
+  }
+}
 
-/* Create a new hash node */
-static HashNode *NewNode(DOH *k, void *obj) {
-  HashNode *hn = (HashNode *) DohMalloc(sizeof(HashNode));
-  hn->key = k;
-  Incref(hn->key);
-  hn->object = obj;
-  Incref(obj);
-  hn->next = 0;
-  return hn;
+/* Find the position of a key in the entries, or -1 if it is not there */
+static int find_entry(Hash *h, DOH *ko, int khv) {
+  DohObjInfo *k_type = ((DohBase *) ko)->type;
+  binop equal = k_type->doh_equal;
+  binop cmp = k_type->doh_cmp;
+  int *hashvals = h->hashvals;
+  DOH *key;
+  int i;
+
+#define KEY_MATCH(i) ((hashvals[i] == khv) && (key = h->entries[i].key) && (((DohBase *) key)->type == k_type) && \
+    ((key == ko) || (equal ? equal(ko, key) : (cmp && (cmp(ko, key) == 0)))))
+
+  if (!h->index) {
+    for (i = 0; i < h->nentries; i++) {
+      if (KEY_MATCH(i))
+	return i;
+    }
+  } else {
+    int slot = (int) ((unsigned int) khv & (unsigned int) h->indexmask);
+    while ((i = h->index[slot])) {
+      if (KEY_MATCH(i - 1))
+	return i - 1;
+      slot = (slot + 1) & h->indexmask;
+    }
+  }
+  return -1;
+#undef KEY_MATCH
+}
+
+/* Add the entry at position pos to the index */
+static void index_insert(Hash *h, int pos) {
+  int slot = (int) ((unsigned int) h->hashvals[pos] & (unsigned int) h->indexmask);
+  while (h->index[slot])
+    slot = (slot + 1) & h->indexmask;
+  h->index[slot] = pos + 1;
+}
+
+/* (Re)build the index, or drop it if the table is small enough to scan */
+static void build_index(Hash *h) {
+  int size, i;
+  DohFree(h->index);
+  h->index = 0;
+  h->indexmask = 0;
+  if (h->maxentries <= HASH_SMALL)
+    return;
+  for (size = 1; size < 2 * h->maxentries; size *= 2);
+  h->index = (int *) DohMalloc(size * sizeof(int));
+  memset(h->index, 0, size * sizeof(int));
+  h->indexmask = size - 1;
+  for (i = 0; i < h->nentries; i++) {
+    if (h->entries[i].key)
+      index_insert(h, i);
+  }
 }
 
-/* Delete a hash node */
-static void DelNode(HashNode *hn) {
-  Delete(hn->key);
-  Delete(hn->object);
-  DohFree(hn);
+/* Make room for one more entry.  Deleted entries are squeezed out and the
+   array only doubles in size if it is at least half full of live entries. */
+static void resize(Hash *h) {
+  int i, j;
+
+  for (i = 0, j = 0; i < h->nentries; i++) {
+    if (h->entries[i].key) {
+      h->entries[j] = h->entries[i];
+      h->hashvals[j++] = h->hashvals[i];
+    }
+  }
+  h->nentries = j;
+  if (2 * h->nitems >= h->maxentries) {
+    Hash old = *h;
+    NewEntries(h, h->maxentries ? 2 * h->maxentries : HASH_INIT_SIZE);
+    if (old.entries) {
+      memcpy(h->entries, old.entries, h->nentries * sizeof(HashEntry));
+      memcpy(h->hashvals, old.hashvals, h->nentries * sizeof(int));
+      DelEntries(&old);
+    }
+  }
+  build_index(h);
 }
 
 /* -----------------------------------------------------------------------------
@@ -109,20 +255,16 @@ static void DelNode(HashNode *hn) {
 
 static void DelHash(DOH *ho) {
   Hash *h = (Hash *) ObjData(ho);
-  HashNode *n, *next;
   int i;
 
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      next = n->next;
-      DelNode(n);
-      n = next;
+  for (i = 0; i < h->nentries; i++) {
+    if (h->entries[i].key) {
+      Delete(h->entries[i].key);
+      Delete(h->entries[i].object);
     }
   }
-  DohFree(h->hashtable);
-  h->hashtable = 0;
-  h->hashsize = 0;
+  DelEntries(h);
+  DohFree(h->index);
   DohFree(h);
 }
 
@@ -134,64 +276,20 @@ static void DelHash(DOH *ho) {
 
 static void Hash_clear(DOH *ho) {
   Hash *h = (Hash *) ObjData(ho);
-  HashNode *n, *next;
   int i;
 
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      next = n->next;
-      DelNode(n);
-      n = next;
+  for (i = 0; i < h->nentries; i++) {
+    if (h->entries[i].key) {
+      Delete(h->entries[i].key);
+      Delete(h->entries[i].object);
+      h->entries[i].key = 0;
+      h->entries[i].object = 0;
     }
-    h->hashtable[i] = 0;
   }
+  h->nentries = 0;
   h->nitems = 0;
-}
-
-/* resize the hash table */
-static void resize(Hash *h) {
-  HashNode *n, *next, **table;
-  int oldsize, newsize;
-  int i, p, hv;
-
-  if (h->nitems < 2 * h->hashsize)
-    return;
-
-  /* Too big. We have to rescale everything now */
-  oldsize = h->hashsize;
-
-  /* Calculate a new size */
-  newsize = 2 * oldsize + 1;
-  p = 3;
-  while (p < (newsize >> 1)) {
-    if (((newsize / p) * p) == newsize) {
-      newsize += 2;
-      p = 3;
-      continue;
-    }
-    p = p + 2;
-  }
-
-  table = (HashNode **) DohMalloc(newsize * sizeof(HashNode *));
-  for (i = 0; i < newsize; i++) {
-    table[i] = 0;
-  }
-
-  /* Walk down the old set of nodes and re-place */
-  h->hashsize = newsize;
-  for (i = 0; i < oldsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      hv = Hashval(n->key) % newsize;
-      next = n->next;
-      n->next = table[hv];
-      table[hv] = n;
-      n = next;
-    }
-  }
-  DohFree(h->hashtable);
-  h->hashtable = table;
+  if (h->index)
+    memset(h->index, 0, (h->indexmask + 1) * sizeof(int));
 }
 
 /* -----------------------------------------------------------------------------
@@ -202,8 +300,8 @@ static void resize(Hash *h) {
  * ----------------------------------------------------------------------------- */
 
 static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
-  int hv;
-  HashNode *n, *prev;
+  int khv, pos;
+  HashEntry *e;
   Hash *h = (Hash *) ObjData(ho);
 
   if (!obj) {
@@ -215,33 +313,33 @@ static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
     obj = NewString((char *) obj);
     Decref(obj);
   }
-  hv = (Hashval(k)) % h->hashsize;
-  n = h->hashtable[hv];
-  prev = 0;
-  while (n) {
-    if (Cmp(n->key, k) == 0) {
-      /* Node already exists.  Just replace its contents */
-      if (n->object == obj) {
-	/* Whoa. Same object.  Do nothing */
-	return 1;
-      }
-      Delete(n->object);
-      n->object = obj;
-      Incref(obj);
-      return 1;			/* Return 1 to indicate a replacement */
-    } else {
-      prev = n;
-      n = n->next;
+  khv = Hashval(k);
+  pos = find_entry(h, k, khv);
+  if (pos >= 0) {
+    /* Entry already exists.  Just replace its contents */
+    e = &h->entries[pos];
+    if (e->object == obj) {
+      /* Whoa. Same object.  Do nothing */
+      return 1;
     }
+    Delete(e->object);
+    e->object = obj;
+    Incref(obj);
+    return 1;			/* Return 1 to indicate a replacement */
   }
-  /* Add this to the table */
-  n = NewNode(k, obj);
-  if (prev)
-    prev->next = n;
-  else
-    h->hashtable[hv] = n;
+  /* Add this to the end of the table */
+  if (h->nentries == h->maxentries)
+    resize(h);
+  e = &h->entries[h->nentries];
+  e->key = k;
+  Incref(k);
+  e->object = obj;
+  Incref(obj);
+  h->hashvals[h->nentries] = khv;
+  if (h->index)
+    index_insert(h, h->nentries);
+  h->nentries++;
   h->nitems++;
-  resize(h);
   return 0;
 }
 
@@ -250,116 +348,73 @@ static int Hash_setattr(DOH *ho, DOH *k, DOH *obj) {
  *
  * Get an attribute from the hash table. Returns 0 if it doesn't exist.
  * ----------------------------------------------------------------------------- */
-typedef int (*binop) (DOH *obj1, DOH *obj2);
 
-
-static DOH *Hash_getattr(DOH *h, DOH *k) {
-  DOH *obj = 0;
-  Hash *ho = (Hash *) ObjData(h);
+static DOH *Hash_getattr(DOH *ho, DOH *k) {
+  Hash *h = (Hash *) ObjData(ho);
   DOH *ko = DohCheck(k) ? k : find_key(k);
-  int hv = Hashval(ko) % ho->hashsize;
-  DohObjInfo *k_type = ((DohBase*)ko)->type;
-  HashNode *n = ho->hashtable[hv];
-  if (k_type->doh_equal) {
-    binop equal = k_type->doh_equal;
-    while (n) {
-      DohBase *nk = (DohBase *)n->key;
-      if ((k_type == nk->type) && equal(ko, nk)) obj = n->object;
-      n = n->next;
-    }
-  } else {
-    binop cmp = k_type->doh_cmp;
-    while (n) {
-      DohBase *nk = (DohBase *)n->key;
-      if ((k_type == nk->type) && (cmp(ko, nk) == 0)) obj = n->object;
-      n = n->next;
-    }
-  }
-  return obj;
+  int pos = find_entry(h, ko, Hashval(ko));
+  return pos >= 0 ? h->entries[pos].object : 0;
 }
 
 /* -----------------------------------------------------------------------------
  * Hash_delattr()
  *
- * Delete an object from the hash table.
+ * Delete an object from the hash table.  The entry is only marked as deleted,
+ * so that the index and any iterators stay valid, unless it is the last entry
+ * of a table without an index.
  * ----------------------------------------------------------------------------- */
 
 static int Hash_delattr(DOH *ho, DOH *k) {
-  HashNode *n, *prev;
-  int hv;
   Hash *h = (Hash *) ObjData(ho);
+  HashEntry *e;
+  int pos;
 
   if (!DohCheck(k))
     k = find_key(k);
-  hv = Hashval(k) % h->hashsize;
-  n = h->hashtable[hv];
-  prev = 0;
-  while (n) {
-    if (Cmp(n->key, k) == 0) {
-      /* Found it, kill it */
-
-      if (prev) {
-	prev->next = n->next;
-      } else {
-	h->hashtable[hv] = n->next;
-      }
-      DelNode(n);
-      h->nitems--;
-      return 1;
-    }
-    prev = n;
-    n = n->next;
+  pos = find_entry(h, k, Hashval(k));
+  if (pos < 0)
+    return 0;
+  e = &h->entries[pos];
+  Delete(e->key);
+  Delete(e->object);
+  e->key = 0;
+  e->object = 0;
+  h->nitems--;
+  if (!h->index) {
+    while (h->nentries > 0 && !h->entries[h->nentries - 1].key)
+      h->nentries--;
   }
-  return 0;
+  return 1;
 }
 
-static DohIterator Hash_firstiter(DOH *ho) {
-  DohIterator iter;
-  Hash *h = (Hash *) ObjData(ho);
-  iter.object = ho;
-  iter._current = 0;
-  iter.item = 0;
-  iter.key = 0;
-  iter._index = 0;		/* Index in hash table */
-  while ((iter._index < h->hashsize) && !h->hashtable[iter._index])
-    iter._index++;
-
-  if (iter._index >= h->hashsize) {
-    return iter;
-  }
-  iter._current = h->hashtable[iter._index];
-  iter.item = ((HashNode *) iter._current)->object;
-  iter.key = ((HashNode *) iter._current)->key;
-
-  /* Actually save the next slot in the hash.  This makes it possible to
-     delete the item being iterated over without trashing the universe */
-  iter._current = ((HashNode *) iter._current)->next;
-  return iter;
-}
+/* Iteration follows insertion order.  The iterator keeps the position of the
+   next entry to look at, so the entry being iterated over can be deleted. */
 
 static DohIterator Hash_nextiter(DohIterator iter) {
   Hash *h = (Hash *) ObjData(iter.object);
-  if (!iter._current) {
+  while ((iter._index < h->nentries) && !h->entries[iter._index].key)
     iter._index++;
-    while ((iter._index < h->hashsize) && !h->hashtable[iter._index]) {
-      iter._index++;
-    }
-    if (iter._index >= h->hashsize) {
-      iter.item = 0;
-      iter.key = 0;
-      iter._current = 0;
-      return iter;
-    }
-    iter._current = h->hashtable[iter._index];
+  if (iter._index >= h->nentries) {
+    iter.item = 0;
+    iter.key = 0;
+    return iter;
   }
-  iter.key = ((HashNode *) iter._current)->key;
-  iter.item = ((HashNode *) iter._current)->object;
-
-  /* Store the next node to iterator on */
-  iter._current = ((HashNode *) iter._current)->next;
+  iter.key = h->entries[iter._index].key;
+  iter.item = h->entries[iter._index].object;
+  iter._index++;
   return iter;
 }
 
+static DohIterator Hash_firstiter(DOH *ho) {
+  DohIterator iter;
+  iter.object = ho;
+  iter._current = 0;
+  iter.item = 0;
+  iter.key = 0;
+  iter._index = 0;		/* Position in the entries */
+  return Hash_nextiter(iter);
+}
+
 /* -----------------------------------------------------------------------------
  * Hash_keys()
  *
@@ -405,7 +460,7 @@ int DohGetMaxHashExpand(void) {
 
 static DOH *Hash_str(DOH *ho) {
   int i, j;
-  HashNode *n;
+  HashEntry *e;
   DOH *s;
   static int expanded = 0;
   static const char *tab = "  ";
@@ -419,28 +474,23 @@ static DOH *Hash_str(DOH *ho) {
   if (expanded >= max_expand) {
     /* replace each hash attribute with a '.' */
     Printf(s, "Hash(%p) {", ho);
-    for (i = 0; i < h->hashsize; i++) {
-      n = h->hashtable[i];
-      while (n) {
+    for (i = 0; i < h->nentries; i++) {
+      if (h->entries[i].key)
 	Putc('.', s);
-	n = n->next;
-      }
     }
     Putc('}', s);
     return s;
   }
   ObjSetMark(ho, 1);
   Printf(s, "Hash(%p) {\n", ho);
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      for (j = 0; j < expanded + 1; j++)
-	Printf(s, tab);
-      expanded += 1;
-      Printf(s, "'%s' : %s, \n", n->key, n->object);
-      expanded -= 1;
-      n = n->next;
-    }
+  for (i = 0, e = h->entries; i < h->nentries; i++, e++) {
+    if (!e->key)
+      continue;
+    for (j = 0; j < expanded + 1; j++)
+      Printf(s, tab);
+    expanded += 1;
+    Printf(s, "'%s' : %s, \n", e->key, e->object);
+    expanded -= 1;
   }
   for (j = 0; j < expanded; j++)
     Printf(s, tab);
@@ -468,36 +518,36 @@ static int Hash_len(DOH *ho) {
 
 static DOH *CopyHash(DOH *ho) {
   Hash *h, *nh;
-  HashNode *n;
-  DOH *nho;
-
   int i;
+
   h = (Hash *) ObjData(ho);
   nh = (Hash *) DohMalloc(sizeof(Hash));
-  nh->hashsize = h->hashsize;
-  nh->hashtable = (HashNode **) DohMalloc(nh->hashsize * sizeof(HashNode *));
-  for (i = 0; i < nh->hashsize; i++) {
-    nh->hashtable[i] = 0;
+  nh->entries = 0;
+  nh->hashvals = 0;
+  nh->maxentries = 0;
+  if (h->maxentries)
+    NewEntries(nh, h->maxentries);
+  nh->nentries = 0;
+  for (i = 0; i < h->nentries; i++) {
+    HashEntry *e = &h->entries[i];
+    if (e->key) {
+      Incref(e->key);
+      Incref(e->object);
+      nh->entries[nh->nentries] = *e;
+      nh->hashvals[nh->nentries++] = h->hashvals[i];
+    }
   }
-  nh->nitems = 0;
+  nh->nitems = nh->nentries;
+  nh->index = 0;
+  build_index(nh);
   nh->line = h->line;
   nh->file = h->file;
   if (nh->file)
     Incref(nh->file);
 
-  nho = DohObjMalloc(&DohHashType, nh);
-  for (i = 0; i < h->hashsize; i++) {
-    n = h->hashtable[i];
-    while (n) {
-      Hash_setattr(nho, n->key, n->object);
-      n = n->next;
-    }
-  }
-  return nho;
+  return DohObjMalloc(&DohHashType, nh);
 }
 
-
-
 static void Hash_setfile(DOH *ho, DOH *file) {
   DOH *fo;
   Hash *h = (Hash *) ObjData(ho);
@@ -527,6 +577,36 @@ static int Hash_getline(DOH *ho) {
   return h->line;
 }
 
+/* -----------------------------------------------------------------------------
+ * DohHashStatistics()
+ *
+ * Accumulate slot usage for a hash table (used by DohMemoryDebug).  Tables
+ * without an index count as small, an entry is displaced if it is not in the
+ * first slot probed for it and the probe length is the number of slots looked
+ * at to find an entry.
+ * ----------------------------------------------------------------------------- */
+
+void DohHashStatistics(DOH *ho, int *nitems, int *nslots, int *nsmall, int *ndisplaced, int *maxprobe) {
+  Hash *h = (Hash *) ObjData(ho);
+  int slot, home, probe;
+  *nitems += h->nitems;
+  if (!h->index) {
+    (*nsmall)++;
+    return;
+  }
+  *nslots += h->indexmask + 1;
+  for (slot = 0; slot <= h->indexmask; slot++) {
+    if (!h->index[slot] || !h->entries[h->index[slot] - 1].key)
+      continue;
+    home = (int) ((unsigned int) h->hashvals[h->index[slot] - 1] & (unsigned int) h->indexmask);
+    probe = ((slot - home) & h->indexmask) + 1;
+    if (probe > 1)
+      (*ndisplaced)++;
+    if (probe > *maxprobe)
+      *maxprobe = probe;
+  }
+}
+
 /* -----------------------------------------------------------------------------
  * type information
  * ----------------------------------------------------------------------------- */
@@ -564,6 +644,247 @@ DohObjInfo DohHashType = {
   0,
 };
 
+/* -----------------------------------------------------------------------------
+ * Chained hash table
+ *
+ * The previous implementation, with a prime number of buckets each holding a
+ * linked list of nodes.  It is only kept so that swig -hash-benchmark can
+ * compare the two tables and is not used otherwise.
+ * ----------------------------------------------------------------------------- */
+
+typedef struct ChainNode {
+  DOH *key;
+  DOH *object;
+  struct ChainNode *next;
+  int hashval;
+} ChainNode;
+
+typedef struct ChainHash {
+  ChainNode **buckets;
+  int nbuckets;
+  int nitems;
+} ChainHash;
+
+#define CHAIN_INIT_SIZE   7
+#define CHAIN_NODE_BLOCK  1024
+
+static const int chain_sizes[] = {
+  17, 37, 79, 163, 331, 673, 1361, 2729, 5471, 10949, 21911, 43853, 87719,
+  175447, 350899, 701819, 1403641, 2807303, 5614657, 11229331, 22458671, 0
+};
+
+static ChainNode *chain_freelist = 0;
+
+static ChainNode **chain_find(ChainHash *h, DOH *k, int khv) {
+  ChainNode **n = &h->buckets[(unsigned int) khv % (unsigned int) h->nbuckets];
+  while (*n && !(((*n)->hashval == khv) && (Cmp((*n)->key, k) == 0)))
+    n = &(*n)->next;
+  return n;
+}
+
+static void chain_resize(ChainHash *h) {
+  ChainNode **buckets, *n, *next;
+  int i, newsize;
+  for (i = 0; chain_sizes[i] && chain_sizes[i] <= h->nbuckets; i++);
+  newsize = chain_sizes[i] ? chain_sizes[i] : 2 * h->nbuckets + 1;
+  buckets = (ChainNode **) DohMalloc(newsize * sizeof(ChainNode *));
+  memset(buckets, 0, newsize * sizeof(ChainNode *));
+  for (i = 0; i < h->nbuckets; i++) {
+    for (n = h->buckets[i]; n; n = next) {
+      int b = (int) ((unsigned int) n->hashval % (unsigned int) newsize);
+      next = n->next;
+      n->next = buckets[b];
+      buckets[b] = n;
+    }
+  }
+  DohFree(h->buckets);
+  h->buckets = buckets;
+  h->nbuckets = newsize;
+}
+
+static void ChainHash_clear(DOH *ho) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  ChainNode *n, *next;
+  int i;
+  for (i = 0; i < h->nbuckets; i++) {
+    for (n = h->buckets[i]; n; n = next) {
+      next = n->next;
+      Delete(n->key);
+      Delete(n->object);
+      n->next = chain_freelist;
+      chain_freelist = n;
+    }
+    h->buckets[i] = 0;
+  }
+  h->nitems = 0;
+}
+
+static void DelChainHash(DOH *ho) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  ChainHash_clear(ho);
+  DohFree(h->buckets);
+  DohFree(h);
+}
+
+static int ChainHash_setattr(DOH *ho, DOH *k, DOH *obj) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  ChainNode **n;
+  int khv;
+  if (!obj)
+    return DohDelattr(ho, k);
+  if (!DohCheck(k))
+    k = find_key(k);
+  if (!DohCheck(obj)) {
+    obj = NewString((char *) obj);
+    Decref(obj);
+  }
+  khv = Hashval(k);
+  n = chain_find(h, k, khv);
+  if (*n) {
+    Incref(obj);
+    Delete((*n)->object);
+    (*n)->object = obj;
+    return 1;
+  }
+  if (!chain_freelist) {
+    int i;
+    ChainNode *block = (ChainNode *) DohMalloc(CHAIN_NODE_BLOCK * sizeof(ChainNode));
+    for (i = 0; i < CHAIN_NODE_BLOCK - 1; i++)
+      block[i].next = &block[i + 1];
+    block[CHAIN_NODE_BLOCK - 1].next = 0;
+    chain_freelist = block;
+  }
+  *n = chain_freelist;
+  chain_freelist = chain_freelist->next;
+  (*n)->key = k;
+  Incref(k);
+  (*n)->object = obj;
+  Incref(obj);
+  (*n)->next = 0;
+  (*n)->hashval = khv;
+  if (++h->nitems >= 2 * h->nbuckets)
+    chain_resize(h);
+  return 0;
+}
+
+static DOH *ChainHash_getattr(DOH *ho, DOH *k) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  ChainNode *n;
+  if (!DohCheck(k))
+    k = find_key(k);
+  n = *chain_find(h, k, Hashval(k));
+  return n ? n->object : 0;
+}
+
+static int ChainHash_delattr(DOH *ho, DOH *k) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  ChainNode **n, *dead;
+  if (!DohCheck(k))
+    k = find_key(k);
+  n = chain_find(h, k, Hashval(k));
+  if (!*n)
+    return 0;
+  dead = *n;
+  *n = dead->next;
+  Delete(dead->key);
+  Delete(dead->object);
+  dead->next = chain_freelist;
+  chain_freelist = dead;
+  h->nitems--;
+  return 1;
+}
+
+static DohIterator ChainHash_nextiter(DohIterator iter) {
+  ChainHash *h = (ChainHash *) ObjData(iter.object);
+  ChainNode *n = (ChainNode *) iter._current;
+  while (!n && ++iter._index < h->nbuckets)
+    n = h->buckets[iter._index];
+  if (!n) {
+    iter.key = 0;
+    iter.item = 0;
+    iter._current = 0;
+    return iter;
+  }
+  iter.key = n->key;
+  iter.item = n->object;
+  iter._current = n->next;
+  return iter;
+}
+
+static DohIterator ChainHash_firstiter(DOH *ho) {
+  DohIterator iter;
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  iter.object = ho;
+  iter._index = 0;
+  iter._current = h->buckets[0];
+  return ChainHash_nextiter(iter);
+}
+
+static int ChainHash_len(DOH *ho) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  return h->nitems;
+}
+
+static DOH *CopyChainHash(DOH *ho) {
+  ChainHash *h = (ChainHash *) ObjData(ho);
+  DOH *nho = DohNewChainedHash();
+  ChainNode *n;
+  int i;
+  for (i = 0; i < h->nbuckets; i++) {
+    for (n = h->buckets[i]; n; n = n->next)
+      ChainHash_setattr(nho, n->key, n->object);
+  }
+  return nho;
+}
+
+static DohHashMethods ChainHashMethods = {
+  ChainHash_getattr,
+  ChainHash_setattr,
+  ChainHash_delattr,
+  Hash_keys,
+};
+
+static DohObjInfo DohChainedHashType = {
+  "ChainedHash",		/* objname */
+  DelChainHash,			/* doh_del */
+  CopyChainHash,		/* doh_copy */
+  ChainHash_clear,		/* doh_clear */
+  0,				/* doh_str */
+  0,				/* doh_data */
+  0,				/* doh_dump */
+  ChainHash_len,		/* doh_len */
+  0,				/* doh_hash    */
+  0,				/* doh_cmp */
+  0,				/* doh_equal    */
+  ChainHash_firstiter,		/* doh_first    */
+  ChainHash_nextiter,		/* doh_next     */
+  0,				/* doh_setfile */
+  0,				/* doh_getfile */
+  0,				/* doh_setline */
+  0,				/* doh_getline */
+  &ChainHashMethods,		/* doh_mapping */
+  0,				/* doh_sequence */
+  0,				/* doh_file */
+  0,				/* doh_string */
+  0,				/* doh_positional */
+  0,
+};
+
+/* -----------------------------------------------------------------------------
+ * NewChainedHash()
+ *
+ * Create a new chained hash table, for benchmarking only.
+ * ----------------------------------------------------------------------------- */
+
+DOH *DohNewChainedHash(void) {
+  ChainHash *h = (ChainHash *) DohMalloc(sizeof(ChainHash));
+  h->nbuckets = CHAIN_INIT_SIZE;
+  h->buckets = (ChainNode **) DohMalloc(h->nbuckets * sizeof(ChainNode *));
+  memset(h->buckets, 0, h->nbuckets * sizeof(ChainNode *));
+  h->nitems = 0;
+  return DohObjMalloc(&DohChainedHashType, h);
+}
+
 /* -----------------------------------------------------------------------------
  * NewHash()
  *
@@ -572,13 +893,13 @@ DohObjInfo DohHashType = {
 
 DOH *DohNewHash(void) {
   Hash *h;
-  int i;
   h = (Hash *) DohMalloc(sizeof(Hash));
-  h->hashsize = HASH_INIT_SIZE;
-  h->hashtable = (HashNode **) DohMalloc(h->hashsize * sizeof(HashNode *));
-  for (i = 0; i < h->hashsize; i++) {
-    h->hashtable[i] = 0;
-  }
+  h->entries = 0;
+  h->hashvals = 0;
+  h->nentries = 0;
+  h->maxentries = 0;
+  h->index = 0;
+  h->indexmask = 0;
   h->nitems = 0;
   h->file = 0;
   h->line = 0;
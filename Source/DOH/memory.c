@@ -34,6 +34,7 @@ typedef struct pool {
   int current;			/* Current position for next allocation */
   char *pbeg;			/* Beg of pool */
   char *pend;			/* End of pool */
+  char *mem;			/* Unaligned block returned by DohMalloc */
   struct pool *next;		/* Next pool */
 } Pool;
 
@@ -41,16 +42,67 @@ static DohBase *FreeList = 0;	/* List of free objects */
 static Pool *Pools = 0;
 static int pools_initialized = 0;
 
+/* Every pool starts on a PoolAlign boundary and is at most PoolAlign bytes long,
+   so the pool owning a pointer is found by masking off the low bits and looking
+   the result up in PoolTable (open addressing, keyed on address >> PoolShift).
+   This keeps DohCheck() constant time regardless of how many pools exist. */
+
+static size_t PoolAlign = 0;
+static int PoolShift = 0;
+static Pool **PoolTable = 0;
+static int PoolTableSize = 0;
+static int PoolTableCount = 0;
+static unsigned long CheckCount = 0;
+
+static unsigned long ObjCount = 0;	/* Objects allocated by DohObjMalloc() */
+static unsigned long MallocBytes = 0;	/* Bytes requested through DohMalloc()/DohRealloc() */
+
+#define POOL_KEY(ptr)        (((size_t) (ptr)) >> PoolShift)
+#define POOL_SLOT(key, size) ((int) (((key) * 2654435761UL) & (size_t) ((size) - 1)))
+
+/* ----------------------------------------------------------------------
+ * PoolTableInsert() - Register the aligned base address of a pool
+ * ---------------------------------------------------------------------- */
+
+static void PoolTableInsert(Pool *p) {
+  size_t key;
+  int slot;
+  if ((PoolTableCount + 1) * 2 > PoolTableSize) {
+    Pool **oldtable = PoolTable;
+    int oldsize = PoolTableSize;
+    int i;
+    PoolTableSize = PoolTableSize ? PoolTableSize * 2 : 64;
+    PoolTable = (Pool **) DohMalloc(sizeof(Pool *) * PoolTableSize);
+    assert(PoolTable);
+    memset(PoolTable, 0, sizeof(Pool *) * PoolTableSize);
+    PoolTableCount = 0;
+    for (i = 0; i < oldsize; i++) {
+      if (oldtable[i])
+	PoolTableInsert(oldtable[i]);
+    }
+    DohFree(oldtable);
+  }
+  key = POOL_KEY(p->pbeg);
+  slot = POOL_SLOT(key, PoolTableSize);
+  while (PoolTable[slot])
+    slot = (slot + 1) & (PoolTableSize - 1);
+  PoolTable[slot] = p;
+  PoolTableCount++;
+}
+
 /* ----------------------------------------------------------------------
  * CreatePool() - Create a new memory pool 
  * ---------------------------------------------------------------------- */
 
 static void CreatePool() {
   Pool *p = 0;
+  size_t addr;
   p = (Pool *) DohMalloc(sizeof(Pool));
   assert(p);
-  p->ptr = (DohBase *) DohMalloc(sizeof(DohBase) * PoolSize);
-  assert(p->ptr);
+  p->mem = (char *) DohMalloc(sizeof(DohBase) * PoolSize + PoolAlign);
+  assert(p->mem);
+  addr = ((size_t) p->mem + PoolAlign - 1) & ~(PoolAlign - 1);
+  p->ptr = (DohBase *) (p->mem + (addr - (size_t) p->mem));
   memset(p->ptr, 0, sizeof(DohBase) * PoolSize);
   p->len = PoolSize;
   p->blen = PoolSize * sizeof(DohBase);
@@ -59,6 +111,7 @@ static void CreatePool() {
   p->pend = p->pbeg + p->blen;
   p->next = Pools;
   Pools = p;
+  PoolTableInsert(p);
 }
 
 /* ----------------------------------------------------------------------
@@ -68,6 +121,12 @@ static void CreatePool() {
 static void InitPools() {
   if (pools_initialized)
     return;
+  PoolAlign = 1;
+  PoolShift = 0;
+  while (PoolAlign < sizeof(DohBase) * PoolSize) {
+    PoolAlign <<= 1;
+    PoolShift++;
+  }
   CreatePool();			/* Create initial pool */
   pools_initialized = 1;
   DohNone = NewVoid(0, 0);	/* Create the None object */
@@ -81,21 +140,28 @@ static void InitPools() {
  * ---------------------------------------------------------------------- */
 
 int DohCheck(const DOH *ptr) {
-  register Pool *p = Pools;
   register char *cptr = (char *) ptr;
-  while (p) {
-    if ((cptr >= p->pbeg) && (cptr < p->pend)) {
+  register Pool *p;
+  size_t key;
+  int slot;
+  CheckCount++;
+  if (!PoolTable)
+    return 0;
+  key = POOL_KEY(cptr);
+  slot = POOL_SLOT(key, PoolTableSize);
+  while ((p = PoolTable[slot])) {
+    if (POOL_KEY(p->pbeg) == key) {
+      if ((cptr >= p->pbeg) && (cptr < p->pend)) {
 #ifdef DOH_DEBUG_MEMORY_POOLS
-      DohBase *b = (DohBase *) ptr;
-      int DOH_object_already_deleted = b->type == 0;
-      assert(!DOH_object_already_deleted);
+	DohBase *b = (DohBase *) ptr;
+	int DOH_object_already_deleted = b->type == 0;
+	assert(!DOH_object_already_deleted);
 #endif
-      return 1;
+	return 1;
+      }
+      return 0;
     }
-    /*
-       pptr = (char *) p->ptr;
-       if ((cptr >= pptr) && (cptr < (pptr+(p->current*sizeof(DohBase))))) return 1; */
-    p = p->next;
+    slot = (slot + 1) & (PoolTableSize - 1);
   }
   return 0;
 }
@@ -133,6 +199,7 @@ DOH *DohObjMalloc(DohObjInfo *type, void *data) {
 #ifndef DOH_DEBUG_MEMORY_POOLS
   }
 #endif
+  ObjCount++;
   obj->type = type;
   obj->data = data;
   obj->meta = 0;
@@ -164,6 +231,38 @@ void DohObjFree(DOH *ptr) {
   }
 }
 
+/* ----------------------------------------------------------------------
+ * DohCountMalloc()
+ * DohCountRealloc()
+ *
+ * Default DohMalloc()/DohRealloc().  These are malloc()/realloc() that also
+ * keep a running total of the number of bytes requested.
+ * ---------------------------------------------------------------------- */
+
+void *DohCountMalloc(size_t size) {
+  MallocBytes += (unsigned long) size;
+  return malloc(size);
+}
+
+void *DohCountRealloc(void *ptr, size_t size) {
+  MallocBytes += (unsigned long) size;
+  return realloc(ptr, size);
+}
+
+/* ----------------------------------------------------------------------
+ * DohMemoryStatistics()
+ *
+ * Return the number of objects and the number of bytes allocated so far.
+ * Both are running totals, freed memory is not subtracted.
+ * ---------------------------------------------------------------------- */
+
+void DohMemoryStatistics(unsigned long *objects, unsigned long *bytes) {
+  if (objects)
+    *objects = ObjCount;
+  if (bytes)
+    *bytes = MallocBytes;
+}
+
 /* ----------------------------------------------------------------------
  * DohMemoryDebug()
  *
@@ -184,6 +283,12 @@ void DohMemoryDebug(void) {
   int numlist = 0;
   int numhash = 0;
 
+  int hashitems = 0;
+  int hashslots = 0;
+  int hashsmall = 0;
+  int hashdisplaced = 0;
+  int hashmaxprobe = 0;
+
   printf("Memory statistics:\n\n");
   printf("Pools:\n");
 
@@ -201,8 +306,10 @@ void DohMemoryDebug(void) {
 	  numstring++;
 	else if (p->ptr[i].type == &DohListType)
 	  numlist++;
-	else if (p->ptr[i].type == &DohHashType)
+	else if (p->ptr[i].type == &DohHashType) {
 	  numhash++;
+	  DohHashStatistics(p->ptr + i, &hashitems, &hashslots, &hashsmall, &hashdisplaced, &hashmaxprobe);
+	}
       }
     }
     printf("    Pool %8p: size = %10d. used = %10d. free = %10d\n", (void *) p, p->len, nused, nfree);
@@ -218,6 +325,16 @@ void DohMemoryDebug(void) {
   printf("    Lists     : %d\n", numlist);
   printf("    Hashes    : %d\n", numhash);
 
+  printf("\nHash tables\n");
+  printf("    Entries   : %d\n", hashitems);
+  printf("    Small     : %d (no index)\n", hashsmall);
+  printf("    Slots     : %d\n", hashslots);
+  printf("    Displaced : %d\n", hashdisplaced);
+  printf("    Max probe : %d\n", hashmaxprobe);
+
+  printf("\nObject checks\n");
+  printf("    DohCheck  : %lu\n", CheckCount);
+
 #if 0
   p = Pools;
   while (p) {
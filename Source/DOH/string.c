@@ -23,9 +23,34 @@ typedef struct String {
   int len;			/* Current length     */
   int hashkey;			/* Hash key value     */
   int sp;			/* Current position   */
+  int lsp;			/* Position that line refers to */
   char *str;			/* String data        */
 } String;
 
+/* -----------------------------------------------------------------------------
+ * String_syncline() - Bring the line number up to date with the file pointer
+ *
+ * Appending to the end of a string moves sp without counting the newlines
+ * that were added.  They are counted here, only when something looks at or
+ * moves the line number, so strings used purely as output buffers never pay
+ * for a per-byte scan.
+ * ----------------------------------------------------------------------------- */
+
+static void String_syncline(String *s) {
+  char *c = s->str + s->lsp;
+  char *end = s->str + s->sp;
+  while (c < end) {
+    c = (char *) memchr(c, '\n', end - c);
+    if (!c)
+      break;
+    s->line++;
+    c++;
+  }
+  s->lsp = s->sp;
+}
+
+#define SYNCLINE(s) do { if ((s)->lsp != (s)->sp) String_syncline(s); } while (0)
+
 /* -----------------------------------------------------------------------------
  * String_data() - Return as a 'void *'
  * ----------------------------------------------------------------------------- */
@@ -68,7 +93,9 @@ static DOH *CopyString(DOH *so) {
   String *s = (String *) ObjData(so);
   str = (String *) DohMalloc(sizeof(String));
   str->hashkey = s->hashkey;
+  SYNCLINE(s);
   str->sp = s->sp;
+  str->lsp = s->lsp;
   str->line = s->line;
   str->file = s->file;
   if (str->file)
@@ -173,30 +200,54 @@ static int String_equal(DOH *so1, DOH *so2) {
 
 /* -----------------------------------------------------------------------------
  * String_hash() - Compute string hash value
+ *
+ * Hashes the full length of the string, four bytes at a time (MurmurHash3).
+ * Mangled type names frequently share long prefixes, so hashing only the
+ * start of the string leads to many collisions.  The result is cached until
+ * the string is modified.
  * ----------------------------------------------------------------------------- */
 
+#define HASH_ROTL(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
 static int String_hash(DOH *so) {
   String *s = (String *) ObjData(so);
   if (s->hashkey >= 0) {
     return s->hashkey;
   } else {
-    register char *c = s->str;
-    register int len = s->len > 50 ? 50 : s->len;
-    register int h = 0;
-    register int mlen = len >> 2;
-    register int i = mlen;
-    for (; i; --i) {
-      h = (h << 5) + *(c++);
-      h = (h << 5) + *(c++);
-      h = (h << 5) + *(c++);
-      h = (h << 5) + *(c++);
+    register const unsigned char *c = (const unsigned char *) s->str;
+    register int len = s->len;
+    register unsigned int h = 0x9747b28cU;
+    register unsigned int k;
+    register int i;
+    for (i = len >> 2; i; --i) {
+      k = (unsigned int) c[0] | ((unsigned int) c[1] << 8) | ((unsigned int) c[2] << 16) | ((unsigned int) c[3] << 24);
+      k *= 0xcc9e2d51U;
+      k = HASH_ROTL(k, 15);
+      k *= 0x1b873593U;
+      h ^= k;
+      h = HASH_ROTL(h, 13);
+      h = h * 5 + 0xe6546b64U;
+      c += 4;
     }
-    for (i = len - (mlen << 2); i; --i) {
-      h = (h << 5) + *(c++);
+    if (len & 3) {
+      k = (unsigned int) c[0];
+      if ((len & 3) > 1)
+	k ^= (unsigned int) c[1] << 8;
+      if ((len & 3) > 2)
+	k ^= (unsigned int) c[2] << 16;
+      k *= 0xcc9e2d51U;
+      k = HASH_ROTL(k, 15);
+      k *= 0x1b873593U;
+      h ^= k;
     }
-    h &= 0x7fffffff;
-    s->hashkey = h;
-    return h;
+    h ^= (unsigned int) len;
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    s->hashkey = (int) (h & 0x7fffffff);
+    return s->hashkey;
   }
 }
 
@@ -205,7 +256,7 @@ static int String_hash(DOH *so) {
  * ----------------------------------------------------------------------------- */
 
 static void DohString_append(DOH *so, const DOHString_or_char *str) {
-  int oldlen, newlen, newmaxsize, l, sp;
+  int oldlen, newlen, newmaxsize, l;
   char *tc;
   String *s = (String *) ObjData(so);
   char *newstr = 0;
@@ -234,14 +285,8 @@ static void DohString_append(DOH *so, const DOHString_or_char *str) {
   }
   tc = s->str;
   memcpy(tc + oldlen, newstr, l + 1);
-  sp = s->sp;
-  if (sp >= oldlen) {
-    int i = oldlen + l - sp;
-    tc += sp;
-    for (; i; --i) {
-      if (*(tc++) == '\n')
-	s->line++;
-    }
+  if (s->sp >= oldlen) {
+    /* The newlines just appended are counted lazily by String_syncline() */
     s->sp = oldlen + l;
   }
   s->len += l;
@@ -258,6 +303,7 @@ static void String_clear(DOH *so) {
   s->len = 0;
   *(s->str) = 0;
   s->sp = 0;
+  s->lsp = 0;
   s->line = 1;
 }
 
@@ -278,6 +324,7 @@ static int String_insert(DOH *so, int pos, DOH *str) {
 
   s = (String *) ObjData(so);
   s->hashkey = -1;
+  SYNCLINE(s);
   if (DohCheck(str)) {
     String *ss = (String *) ObjData(str);
     data = (char *) String_data(str);
@@ -309,6 +356,7 @@ static int String_insert(DOH *so, int pos, DOH *str) {
 	s->line++;
     }
     s->sp += len;
+    s->lsp = s->sp;
   }
   s->len += len;
   s->str[s->len] = 0;
@@ -329,8 +377,10 @@ static int String_delitem(DOH *so, int pos) {
   if (s->len == 0)
     return 0;
 
+  SYNCLINE(s);
   if (s->sp > pos) {
     s->sp--;
+    s->lsp = s->sp;
     assert(s->sp >= 0);
     if (s->str[pos] == '\n')
       s->line--;
@@ -357,6 +407,7 @@ static int String_delslice(DOH *so, int sindex, int eindex) {
     sindex = 0;
 
   size = eindex - sindex;
+  SYNCLINE(s);
   if (s->sp > sindex) {
     /* Adjust the file pointer and line count */
     int i, end;
@@ -371,6 +422,7 @@ static int String_delslice(DOH *so, int sindex, int eindex) {
       if (s->str[i] == '\n')
 	s->line--;
     }
+    s->lsp = s->sp;
     assert(s->sp >= 0);
   }
   memmove(s->str + sindex, s->str + eindex, s->len - eindex);
@@ -397,6 +449,7 @@ static int String_read(DOH *so, void *buffer, int len) {
   int reallen, retlen;
   char *cb;
   String *s = (String *) ObjData(so);
+  SYNCLINE(s);
   if ((s->sp + len) > s->len)
     reallen = (s->len - s->sp);
   else
@@ -408,6 +461,7 @@ static int String_read(DOH *so, void *buffer, int len) {
   if (reallen > 0) {
     memmove(cb, s->str + s->sp, reallen);
     s->sp += reallen;
+    s->lsp = s->sp;
   }
   return retlen;
 }
@@ -416,22 +470,28 @@ static int String_read(DOH *so, void *buffer, int len) {
  * String_write() - Write data to a string
  * ----------------------------------------------------------------------------- */
 static int String_write(DOH *so, const void *buffer, int len) {
-  int newlen;
+  int newlen, newmaxsize;
   String *s = (String *) ObjData(so);
   s->hashkey = -1;
+  SYNCLINE(s);
   if (s->sp > s->len)
     s->sp = s->len;
   newlen = s->sp + len + 1;
   if (newlen > s->maxsize) {
-    s->str = (char *) DohRealloc(s->str, newlen);
+    /* Grow geometrically so that repeated Printf()s into an output section are amortized */
+    newmaxsize = 2 * s->maxsize;
+    if (newlen > newmaxsize)
+      newmaxsize = newlen;
+    s->str = (char *) DohRealloc(s->str, newmaxsize);
     assert(s->str);
-    s->maxsize = newlen;
+    s->maxsize = newmaxsize;
     s->len = s->sp + len;
   }
   if ((s->sp + len) > s->len)
     s->len = s->sp + len;
   memmove(s->str + s->sp, buffer, len);
   s->sp += len;
+  s->lsp = s->sp;
   s->str[s->len] = 0;
   return len;
 }
@@ -443,6 +503,7 @@ static int String_write(DOH *so, const void *buffer, int len) {
 static int String_seek(DOH *so, long offset, int whence) {
   int pos, nsp, inc;
   String *s = (String *) ObjData(so);
+  SYNCLINE(s);
   if (whence == SEEK_SET)
     pos = 0;
   else if (whence == SEEK_CUR)
@@ -488,6 +549,7 @@ static int String_seek(DOH *so, long offset, int whence) {
     }
 #endif
     s->sp = sp;
+    s->lsp = sp;
   }
   assert(s->sp >= 0);
   return 0;
@@ -509,8 +571,10 @@ static long String_tell(DOH *so) {
 static int String_putc(DOH *so, int ch) {
   String *s = (String *) ObjData(so);
   register int len = s->len;
-  register int sp = s->sp;
+  register int sp;
   s->hashkey = -1;
+  SYNCLINE(s);
+  sp = s->sp;
   if (sp >= len) {
     register int maxsize = s->maxsize;
     register char *tc = s->str;
@@ -528,6 +592,7 @@ static int String_putc(DOH *so, int ch) {
   } else {
     s->str[s->sp++] = (char) ch;
   }
+  s->lsp = s->sp;
   if (ch == '\n')
     s->line++;
   return ch;
@@ -540,10 +605,12 @@ static int String_putc(DOH *so, int ch) {
 static int String_getc(DOH *so) {
   int c;
   String *s = (String *) ObjData(so);
+  SYNCLINE(s);
   if (s->sp >= s->len)
     c = EOF;
   else
     c = (int)(unsigned char) s->str[s->sp++];
+  s->lsp = s->sp;
   if (c == '\n')
     s->line++;
   return c;
@@ -559,7 +626,9 @@ static int String_ungetc(DOH *so, int ch) {
     return ch;
   if (s->sp <= 0)
     return EOF;
+  SYNCLINE(s);
   s->sp--;
+  s->lsp = s->sp;
   if (ch == '\n')
     s->line--;
   return ch;
@@ -901,22 +970,167 @@ static int replace_simple(String *str, char *token, char *rep, int flags, int co
 
 static int String_replace(DOH *stro, const DOHString_or_char *token, const DOHString_or_char *rep, int flags) {
   int count = -1;
+  int rcount;
   String *str = (String *) ObjData(stro);
 
+  SYNCLINE(str);
   if (flags & DOH_REPLACE_FIRST)
     count = 1;
 
   if (flags & DOH_REPLACE_ID_END) {
-    return replace_simple(str, Char(token), Char(rep), flags, count, match_identifier_end);
+    rcount = replace_simple(str, Char(token), Char(rep), flags, count, match_identifier_end);
   } else if (flags & DOH_REPLACE_ID_BEGIN) {
-    return replace_simple(str, Char(token), Char(rep), flags, count, match_identifier_begin);
+    rcount = replace_simple(str, Char(token), Char(rep), flags, count, match_identifier_begin);
   } else if (flags & DOH_REPLACE_ID) {
-    return replace_simple(str, Char(token), Char(rep), flags, count, match_identifier);
+    rcount = replace_simple(str, Char(token), Char(rep), flags, count, match_identifier);
   } else if (flags & DOH_REPLACE_NUMBER_END) {
-    return replace_simple(str, Char(token), Char(rep), flags, count, match_number_end);
+    rcount = replace_simple(str, Char(token), Char(rep), flags, count, match_number_end);
   } else {
-    return replace_simple(str, Char(token), Char(rep), flags, count, match_simple);
+    rcount = replace_simple(str, Char(token), Char(rep), flags, count, match_simple);
+  }
+  str->lsp = str->sp;
+  return rcount;
+}
+
+/* -----------------------------------------------------------------------------
+ * String_replacemulti()
+ *
+ * Replaces several different tokens in a single scan of the string.  Each item
+ * has its own DOH_REPLACE_* flags with the same meaning as for Replace().  Where
+ * more than one token matches at the same position, the longest one wins.  The
+ * text is scanned once and replacement text is never rescanned, so the result
+ * does not depend on the order of the items.  The number of replacements made
+ * for each item is stored in its count field.
+ * ----------------------------------------------------------------------------- */
+
+#define IS_IDCHAR(c) (isalnum((int) (c)) || ((c) == '_'))
+
+static int String_replacemulti(DOH *so, DohReplaceItem *items, int nitems) {
+  String *str = (String *) ObjData(so);
+  char first[256];
+  int *tokenlen;
+  char **rep;
+  int *replen;
+  char *base, *end, *c, *copied, *quote_end = 0;
+  char *ns = 0;
+  int nslen = 0, nsmax = 0;
+  int noquote = 0;
+  int rcount = 0;
+  int i;
+
+  if (nitems <= 0)
+    return 0;
+
+  tokenlen = (int *) DohMalloc(2 * nitems * sizeof(int));
+  replen = tokenlen + nitems;
+  rep = (char **) DohMalloc(nitems * sizeof(char *));
+  memset(first, 0, sizeof(first));
+  for (i = 0; i < nitems; i++) {
+    tokenlen[i] = (int) strlen(items[i].token);
+    rep[i] = items[i].rep ? Char(items[i].rep) : (char *) "";
+    replen[i] = (int) strlen(rep[i]);
+    items[i].count = 0;
+    if (tokenlen[i]) {
+      first[(unsigned char) items[i].token[0]] = 1;
+      if (items[i].flags & DOH_REPLACE_NOQUOTE)
+	noquote = 1;
+    }
+  }
+  if (noquote) {
+    first[(unsigned char) '"'] = 1;
+    first[(unsigned char) '\''] = 1;
+  }
+
+  SYNCLINE(str);
+  base = str->str;
+  end = base + str->len;
+  copied = base;
+  for (c = base; c < end; c++) {
+    int best = -1;
+    int bestlen = 0;
+    if (!first[(unsigned char) *c])
+      continue;
+    if (noquote && (c > quote_end) && ((*c == '"') || (*c == '\''))) {
+      /* Tokens marked DOH_REPLACE_NOQUOTE are not replaced up to the closing quote */
+      quote_end = end_quote(c);
+      if (!quote_end)
+	quote_end = end;
+    }
+    for (i = 0; i < nitems; i++) {
+      int len = tokenlen[i];
+      int flags = items[i].flags;
+      char *e = c + len;
+      if ((len <= bestlen) || (e > end) || (items[i].token[0] != *c) || (strncmp(c, items[i].token, len) != 0))
+	continue;
+      if ((flags & DOH_REPLACE_NOQUOTE) && (c < quote_end))
+	continue;
+      if ((flags & DOH_REPLACE_FIRST) && items[i].count)
+	continue;
+      if (flags & DOH_REPLACE_ID_END) {
+	if (IS_IDCHAR(*e))
+	  continue;
+      } else if (flags & DOH_REPLACE_ID_BEGIN) {
+	if ((c > base) && IS_IDCHAR(*(c - 1)))
+	  continue;
+      } else if (flags & DOH_REPLACE_ID) {
+	if (((c > base) && IS_IDCHAR(*(c - 1))) || IS_IDCHAR(*e))
+	  continue;
+      } else if (flags & DOH_REPLACE_NUMBER_END) {
+	if (isdigit((int) *e))
+	  continue;
+      }
+      best = i;
+      bestlen = len;
+    }
+    if (best < 0)
+      continue;
+
+    /* Copy the unchanged text before the token, followed by the replacement */
+    if (nslen + (c - copied) + replen[best] + 1 > nsmax) {
+      nsmax = 2 * nsmax;
+      if (nsmax < str->len + 1)
+	nsmax = str->len + 1;
+      while (nslen + (c - copied) + replen[best] + 1 > nsmax)
+	nsmax *= 2;
+      ns = ns ? (char *) DohRealloc(ns, nsmax) : (char *) DohMalloc(nsmax);
+      assert(ns);
+    }
+    memcpy(ns + nslen, copied, c - copied);
+    nslen += (int) (c - copied);
+    memcpy(ns + nslen, rep[best], replen[best]);
+    nslen += replen[best];
+    items[best].count++;
+    rcount++;
+    copied = c + bestlen;
+    c = copied - 1;
+  }
+
+  if (rcount) {
+    int tail = (int) (end - copied);
+    int newsp;
+    if (nslen + tail + 1 > nsmax) {
+      nsmax = nslen + tail + 1;
+      ns = (char *) DohRealloc(ns, nsmax);
+      assert(ns);
+    }
+    memcpy(ns + nslen, copied, tail);
+    nslen += tail;
+    ns[nslen] = 0;
+    /* As with Replace(), the file pointer only follows the text when it is at the end */
+    newsp = (str->sp >= str->len) ? nslen : str->sp;
+    if (newsp > nslen)
+      newsp = nslen;
+    DohFree(str->str);
+    str->str = ns;
+    str->len = nslen;
+    str->maxsize = nsmax;
+    str->sp = newsp;
+    str->lsp = newsp;
+    str->hashkey = -1;
   }
+  DohFree(rep);
+  DohFree(tokenlen);
+  return rcount;
 }
 
 /* -----------------------------------------------------------------------------
@@ -926,6 +1140,7 @@ static int String_replace(DOH *stro, const DOHString_or_char *token, const DOHSt
 static void String_chop(DOH *so) {
   char *c;
   String *str = (String *) ObjData(so);
+  SYNCLINE(str);
   /* Replace trailing whitespace */
   c = str->str + str->len - 1;
   while ((str->len > 0) && (isspace((int) *c))) {
@@ -938,6 +1153,7 @@ static void String_chop(DOH *so) {
     c--;
   }
   str->str[str->len] = 0;
+  str->lsp = str->sp;
   assert(str->sp >= 0);
   str->hashkey = -1;
 }
@@ -963,11 +1179,13 @@ static DOH *String_getfile(DOH *so) {
 
 static void String_setline(DOH *so, int line) {
   String *str = (String *) ObjData(so);
+  str->lsp = str->sp;
   str->line = line;
 }
 
 static int String_getline(DOH *so) {
   String *str = (String *) ObjData(so);
+  SYNCLINE(str);
   return str->line;
 }
 
@@ -993,6 +1211,7 @@ static DohFileMethods StringFileMethods = {
 static DohStringMethods StringStringMethods = {
   String_replace,
   String_chop,
+  String_replacemulti,
 };
 
 DohObjInfo DohStringType = {
@@ -1046,6 +1265,7 @@ DOHString *DohNewString(const DOHString_or_char *so) {
   str = (String *) DohMalloc(sizeof(String));
   str->hashkey = hashkey;
   str->sp = 0;
+  str->lsp = 0;
   str->line = 1;
   str->file = 0;
   max = INIT_MAXSIZE;
@@ -1059,6 +1279,7 @@ DOHString *DohNewString(const DOHString_or_char *so) {
     strcpy(str->str, s);
     str->len = l;
     str->sp = l;
+    str->lsp = l;
   } else {
     str->str[0] = 0;
     str->len = 0;
@@ -1074,8 +1295,9 @@ DOHString *DohNewString(const DOHString_or_char *so) {
 DOHString *DohNewStringEmpty(void) {
   int max = INIT_MAXSIZE;
   String *str = (String *) DohMalloc(sizeof(String));
-  str->hashkey = 0;
+  str->hashkey = -1;
   str->sp = 0;
+  str->lsp = 0;
   str->line = 1;
   str->file = 0;
   str->str = (char *) DohMalloc(max);
@@ -1102,6 +1324,7 @@ DOHString *DohNewStringWithSize(const DOHString_or_char *so, int len) {
   str = (String *) DohMalloc(sizeof(String));
   str->hashkey = -1;
   str->sp = 0;
+  str->lsp = 0;
   str->line = 1;
   str->file = 0;
   max = INIT_MAXSIZE;
@@ -1116,6 +1339,7 @@ DOHString *DohNewStringWithSize(const DOHString_or_char *so, int len) {
     strncpy(str->str, s, len);
     str->len = l;
     str->sp = l;
+    str->lsp = l;
   } else {
     str->str[0] = 0;
     str->len = 0;
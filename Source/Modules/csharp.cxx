@@ -321,10 +321,15 @@ public:
       SWIG_exit(EXIT_FAILURE);
     }
 
-    f_begin = NewFile(outfile, "w", SWIG_output_files());
-    if (!f_begin) {
-      FileErrorDisplay(outfile);
-      SWIG_exit(EXIT_FAILURE);
+    if (SWIG_output_shards() > 1) {
+      // Becomes the header common to all the shards written by Swig_shards_write()
+      f_begin = NewString("");
+    } else {
+      f_begin = NewFile(outfile, "w", SWIG_output_files());
+      if (!f_begin) {
+	FileErrorDisplay(outfile);
+	SWIG_exit(EXIT_FAILURE);
+      }
     }
 
     if (directorsEnabled()) {
@@ -417,7 +422,7 @@ public:
       Printf(f_directors, "/* ---------------------------------------------------\n");
       Printf(f_directors, " * C++ director class methods\n");
       Printf(f_directors, " * --------------------------------------------------- */\n\n");
-      if (outfile_h) {
+      if (outfile_h && SWIG_output_shards() <= 1) {
 	String *filename = Swig_file_filename(outfile_h);
 	Printf(f_directors, "#include \"%s\"\n\n", filename);
 	Delete(filename);
@@ -432,9 +437,11 @@ public:
       Swig_name_register("get", "get_%n%v");
     }
 
-    Printf(f_wrappers, "\n#ifdef __cplusplus\n");
-    Printf(f_wrappers, "extern \"C\" {\n");
-    Printf(f_wrappers, "#endif\n\n");
+    if (SWIG_output_shards() <= 1) {
+      Printf(f_wrappers, "\n#ifdef __cplusplus\n");
+      Printf(f_wrappers, "extern \"C\" {\n");
+      Printf(f_wrappers, "#endif\n\n");
+    }
 
     /* Emit code */
     Language::top(n);
@@ -555,9 +562,11 @@ public:
     if (upcasts_code)
       Printv(f_wrappers, upcasts_code, NIL);
 
-    Printf(f_wrappers, "#ifdef __cplusplus\n");
-    Printf(f_wrappers, "}\n");
-    Printf(f_wrappers, "#endif\n");
+    if (SWIG_output_shards() <= 1) {
+      Printf(f_wrappers, "#ifdef __cplusplus\n");
+      Printf(f_wrappers, "}\n");
+      Printf(f_wrappers, "#endif\n");
+    }
 
     // Output a C# type wrapper class for each SWIG type
     for (Iterator swig_type = First(swig_types_hash); swig_type.key; swig_type = Next(swig_type)) {
@@ -633,8 +642,21 @@ public:
     Dump(f_runtime, f_begin);
     Dump(f_header, f_begin);
 
+    if (SWIG_output_shards() > 1) {
+      if (directorsEnabled() && outfile_h) {
+	String *filename = Swig_file_filename(outfile_h);
+	Printf(f_begin, "\n#include \"%s\"\n", filename);
+	Delete(filename);
+      }
+      String *init = NewString("");
+      Wrapper_pretty_print(f_init, init);
+      Swig_shards_write(outfile, f_begin, f_directors, f_wrappers, init, 1);
+      Delete(init);
+    }
+
     if (directorsEnabled()) {
-      Dump(f_directors, f_begin);
+      if (SWIG_output_shards() <= 1)
+	Dump(f_directors, f_begin);
       Dump(f_directors_h, f_runtime_h);
 
       Printf(f_runtime_h, "\n");
@@ -648,8 +670,10 @@ public:
       f_directors_h = NULL;
     }
 
-    Dump(f_wrappers, f_begin);
-    Wrapper_pretty_print(f_init, f_begin);
+    if (SWIG_output_shards() <= 1) {
+      Dump(f_wrappers, f_begin);
+      Wrapper_pretty_print(f_init, f_begin);
+    }
     Delete(f_header);
     Delete(f_wrappers);
     Delete(f_init);
@@ -658,6 +682,14 @@ public:
     return SWIG_OK;
   }
 
+  /* -----------------------------------------------------------------------------
+   * supportsOutputShards()
+   * ----------------------------------------------------------------------------- */
+
+  virtual int supportsOutputShards() {
+    return 1;
+  }
+
   /* -----------------------------------------------------------------------------
    * emitBanner()
    * ----------------------------------------------------------------------------- */
@@ -1038,6 +1070,7 @@ public:
     /* Dump the function out */
     if (!native_function_flag) {
       Wrapper_print(f, f_wrappers);
+      Swig_shard_mark(f_wrappers);
 
       // Handle %csexception which sets the canthrow attribute
       if (Getattr(n, "feature:except:canthrow"))
@@ -4042,6 +4075,7 @@ public:
       if (!Getattr(n, "defaultargs")) {
 	Replaceall(w->code, "$symname", symname);
 	Wrapper_print(w, f_directors);
+	Swig_shard_mark(f_directors);
 	Printv(f_directors_h, declaration, NIL);
 	Printv(f_directors_h, inline_extra_method, NIL);
       }
@@ -435,14 +435,15 @@ private:
 
     /* Write and cleanup */
 
-    Dump(f_c_header, f_c_runtime);
+    Dump(f_c_runtime, f_c_begin);
+    Dump(f_c_header, f_c_begin);
 
     if (directorsEnabled()) {
       Printf(f_c_directors_h, "#endif\n");
       Delete(f_c_directors_h);
       f_c_directors_h = NULL;
 
-      Dump(f_c_directors, f_c_runtime);
+      Dump(f_c_directors, f_c_begin);
       Delete(f_c_directors);
       f_c_directors = NULL;
     }
@@ -450,7 +451,6 @@ private:
     // End the extern "C".
     Printv(f_c_wrappers, "#ifdef __cplusplus\n", "}\n", "#endif\n\n", NULL);
 
-    Dump(f_c_runtime, f_c_begin);
     Dump(f_c_wrappers, f_c_begin);
     Dump(f_c_init, f_c_begin);
     Dump(f_go_header, f_go_begin);
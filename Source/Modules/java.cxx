@@ -359,10 +359,15 @@ public:
       SWIG_exit(EXIT_FAILURE);
     }
 
-    f_begin = NewFile(outfile, "w", SWIG_output_files());
-    if (!f_begin) {
-      FileErrorDisplay(outfile);
-      SWIG_exit(EXIT_FAILURE);
+    if (SWIG_output_shards() > 1) {
+      // Becomes the header common to all the shards written by Swig_shards_write()
+      f_begin = NewString("");
+    } else {
+      f_begin = NewFile(outfile, "w", SWIG_output_files());
+      if (!f_begin) {
+	FileErrorDisplay(outfile);
+	SWIG_exit(EXIT_FAILURE);
+      }
     }
 
     if (directorsEnabled()) {
@@ -456,7 +461,7 @@ public:
       Printf(f_directors, "/* ---------------------------------------------------\n");
       Printf(f_directors, " * C++ director class methods\n");
       Printf(f_directors, " * --------------------------------------------------- */\n\n");
-      if (outfile_h) {
+      if (outfile_h && SWIG_output_shards() <= 1) {
 	String *filename = Swig_file_filename(outfile_h);
 	Printf(f_directors, "#include \"%s\"\n\n", filename);
 	Delete(filename);
@@ -488,9 +493,11 @@ public:
 
     Delete(wrapper_name);
 
-    Printf(f_wrappers, "\n#ifdef __cplusplus\n");
-    Printf(f_wrappers, "extern \"C\" {\n");
-    Printf(f_wrappers, "#endif\n\n");
+    if (SWIG_output_shards() <= 1) {
+      Printf(f_wrappers, "\n#ifdef __cplusplus\n");
+      Printf(f_wrappers, "extern \"C\" {\n");
+      Printf(f_wrappers, "#endif\n\n");
+    }
 
     /* Emit code */
     Language::top(n);
@@ -654,9 +661,11 @@ public:
 
     emitDirectorUpcalls();
 
-    Printf(f_wrappers, "#ifdef __cplusplus\n");
-    Printf(f_wrappers, "}\n");
-    Printf(f_wrappers, "#endif\n");
+    if (SWIG_output_shards() <= 1) {
+      Printf(f_wrappers, "#ifdef __cplusplus\n");
+      Printf(f_wrappers, "}\n");
+      Printf(f_wrappers, "#endif\n");
+    }
 
     // Output a Java type wrapper class for each SWIG type
     for (Iterator swig_type = First(swig_types_hash); swig_type.key; swig_type = Next(swig_type)) {
@@ -739,10 +748,24 @@ public:
     n_dmethods = 0;
 
     /* Close all of the files */
-    Dump(f_header, f_runtime);
+    Dump(f_runtime, f_begin);
+    Dump(f_header, f_begin);
+
+    if (SWIG_output_shards() > 1) {
+      if (directorsEnabled() && outfile_h) {
+	String *filename = Swig_file_filename(outfile_h);
+	Printf(f_begin, "\n#include \"%s\"\n", filename);
+	Delete(filename);
+      }
+      String *init = NewString("");
+      Wrapper_pretty_print(f_init, init);
+      Swig_shards_write(outfile, f_begin, f_directors, f_wrappers, init, 1);
+      Delete(init);
+    }
 
     if (directorsEnabled()) {
-      Dump(f_directors, f_runtime);
+      if (SWIG_output_shards() <= 1)
+	Dump(f_directors, f_begin);
       Dump(f_directors_h, f_runtime_h);
 
       Printf(f_runtime_h, "\n");
@@ -756,17 +779,26 @@ public:
       f_directors_h = NULL;
     }
 
-    Dump(f_wrappers, f_runtime);
-    Wrapper_pretty_print(f_init, f_runtime);
+    if (SWIG_output_shards() <= 1) {
+      Dump(f_wrappers, f_begin);
+      Wrapper_pretty_print(f_init, f_begin);
+    }
     Delete(f_header);
     Delete(f_wrappers);
     Delete(f_init);
-    Dump(f_runtime, f_begin);
     Delete(f_runtime);
     Delete(f_begin);
     return SWIG_OK;
   }
 
+  /* -----------------------------------------------------------------------------
+   * supportsOutputShards()
+   * ----------------------------------------------------------------------------- */
+
+  virtual int supportsOutputShards() {
+    return 1;
+  }
+
   /* -----------------------------------------------------------------------------
    * emitBanner()
    * ----------------------------------------------------------------------------- */
@@ -1158,8 +1190,10 @@ public:
       Replaceall(f->code, "$null", "");
 
     /* Dump the function out */
-    if (!native_function_flag)
+    if (!native_function_flag) {
       Wrapper_print(f, f_wrappers);
+      Swig_shard_mark(f_wrappers);
+    }
 
     if (!(proxy_flag && is_wrapping_class()) && !enum_constant_flag) {
       moduleClassFunctionHandler(n);
@@ -3483,10 +3517,20 @@ public:
       }
 
       Printf(f_runtime, "namespace Swig {\n");
-      Printf(f_runtime, "  namespace {\n");
-      Printf(f_runtime, "    jclass jclass_%s = NULL;\n", imclass_name);
-      Printf(f_runtime, "    jmethodID director_methids[%d];\n", n_methods);
-      Printf(f_runtime, "  }\n");
+      if (SWIG_output_shards() > 1) {
+	// The upcall method ids are set in one shard and used in the others
+	Printf(f_runtime, "  extern jclass jclass_%s;\n", imclass_name);
+	Printf(f_runtime, "  extern jmethodID director_methids[%d];\n", n_methods);
+	Printf(f_runtime, "#ifdef SWIG_OUTSHARD_PRIMARY\n");
+	Printf(f_runtime, "  jclass jclass_%s = NULL;\n", imclass_name);
+	Printf(f_runtime, "  jmethodID director_methids[%d];\n", n_methods);
+	Printf(f_runtime, "#endif\n");
+      } else {
+	Printf(f_runtime, "  namespace {\n");
+	Printf(f_runtime, "    jclass jclass_%s = NULL;\n", imclass_name);
+	Printf(f_runtime, "    jmethodID director_methids[%d];\n", n_methods);
+	Printf(f_runtime, "  }\n");
+      }
       Printf(f_runtime, "}\n");
 
       Printf(w->def, "SWIGEXPORT void JNICALL Java_%s%s_%s(JNIEnv *jenv, jclass jcls) {", jnipackage, jni_imclass_name, swig_module_init_jni);
@@ -4217,6 +4261,7 @@ public:
       if (!Getattr(n, "defaultargs")) {
 	Replaceall(w->code, "$symname", symname);
 	Wrapper_print(w, f_directors);
+	Swig_shard_mark(f_directors);
 	Printv(f_directors_h, declaration, NIL);
 	Printv(f_directors_h, inline_extra_method, NIL);
       }
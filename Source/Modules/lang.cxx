@@ -652,7 +652,10 @@ int Language::insertDirective(Node *n) {
       f = Swig_filebyname(section);
     }
     if (f) {
+      int start = DohIsString(f) ? Len(f) : 0;
       Printf(f, "%s\n", code);
+      if (section && Equal(section, "wrapper"))
+	Swig_shard_shared(f, start);	/* Helpers for the wrappers in any -outshards file */
     } else {
       Swig_error(input_file, line_number, "Unknown target '%s' for %%insert directive.\n", section);
     }
@@ -1797,38 +1800,59 @@ static String *vtable_method_id(Node *n) {
 
 
 /* ----------------------------------------------------------------------
- * Language::unrollVirtualMethods()
+ * Language::classVtable()
+ *
+ * Returns the virtual methods contributed by class n and its bases in the
+ * order unrollVirtualMethods() visits them. Each entry holds the method
+ * "node", its declaring "class" and its "vmid". The result does not depend
+ * on the class being wrapped, so it is built once per class and access mode
+ * and cached on the class node, where derived classes pick it up.
  * ---------------------------------------------------------------------- */
-int Language::unrollVirtualMethods(Node *n, Node *parent, List *vm, int default_director, int &virtual_destructor, int protectedbase) {
+
+Hash *Language::classVtable(Node *n, int protectedbase) {
+  Hash *cache = Getattr(n, "$vtablecache");
+  if (!cache) {
+    cache = NewHash();
+    Setattr(n, "$vtablecache", cache);
+    Delete(cache);
+  }
+  String *mode = NewStringf("%d%d%d%d", protectedbase, dirprot_mode(), directorsEnabled() && DirectorClassName, director_multiple_inheritance);
+  Hash *vtable = Getattr(cache, mode);
+  if (vtable) {
+    Delete(mode);
+    return vtable;
+  }
+
+  vtable = NewHash();
+  List *entries = NewList();
+  Setattr(vtable, "entries", entries);
+  Setattr(cache, mode, vtable);
+  Delete(mode);
+
   Node *ni;
   String *nodeType;
-  String *classname;
   String *decl;
   bool first_base = false;
-  // recurse through all base classes to build the vtable
-  List *bl = Getattr(n, "bases");
-  if (bl) {
-    Iterator bi;
-    for (bi = First(bl); bi.item; bi = Next(bi)) {
-      if (first_base && !director_multiple_inheritance)
-	break;
-      unrollVirtualMethods(bi.item, parent, vm, default_director, virtual_destructor);
-      first_base = true;
-    }
-  }
-  // recurse through all protected base classes to build the vtable, as needed
-  bl = Getattr(n, "protectedbases");
-  if (bl) {
-    Iterator bi;
-    for (bi = First(bl); bi.item; bi = Next(bi)) {
-      if (first_base && !director_multiple_inheritance)
-	break;
-      unrollVirtualMethods(bi.item, parent, vm, default_director, virtual_destructor, 1);
-      first_base = true;
+  // collect the vtables of all the base classes
+  const char *basekinds[] = { "bases", "protectedbases" };
+  for (int k = 0; k < 2; k++) {
+    List *bl = Getattr(n, basekinds[k]);
+    if (bl) {
+      Iterator bi;
+      for (bi = First(bl); bi.item; bi = Next(bi)) {
+	if (first_base && !director_multiple_inheritance)
+	  break;
+	Hash *basevtable = classVtable(bi.item, k);
+	Iterator ei;
+	for (ei = First(Getattr(basevtable, "entries")); ei.item; ei = Next(ei))
+	  Append(entries, ei.item);
+	if (GetFlag(basevtable, "virtual_destructor"))
+	  SetFlag(vtable, "virtual_destructor");
+	first_base = true;
+      }
     }
   }
   // find the methods that need directors
-  classname = Getattr(n, "name");
   for (ni = Getattr(n, "firstChild"); ni; ni = nextSibling(ni)) {
     /* we only need to check the virtual members */
     nodeType = Getattr(ni, "nodeType");
@@ -1848,54 +1872,77 @@ int Language::unrollVirtualMethods(Node *n, Node *parent, List *vm, int default_
       decl = Getattr(nn, "decl");
       /* extra check for function type and proper access */
       if (SwigType_isfunction(decl) && (((!protectedbase || dirprot_mode()) && is_public(nn)) || need_nonpublic_member(nn))) {
-	String *name = Getattr(nn, "name");
 	Node *method_id = is_destructor ? NewStringf("~destructor") : vtable_method_id(nn);
-	/* Make sure that the new method overwrites the existing: */
-	int len = Len(vm);
-	const int DO_NOT_REPLACE = -1;
-	int replace = DO_NOT_REPLACE;
-	for (int i = 0; i < len; i++) {
-	  Node *item = Getitem(vm, i);
-	  String *check_vmid = Getattr(item, "vmid");
-
-	  if (Strcmp(method_id, check_vmid) == 0) {
-	    replace = i;
-	    break;
-	  }
-	}
-	/* filling a new method item */
-	String *fqdname = NewStringf("%s::%s", classname, name);
-	Hash *item = NewHash();
-	Setattr(item, "fqdname", fqdname);
-	Node *m = Copy(nn);
-
-	/* Store the complete return type - needed for non-simple return types (pointers, references etc.) */
-	SwigType *ty = NewString(Getattr(m, "type"));
-	SwigType_push(ty, decl);
-	if (SwigType_isqualifier(ty)) {
-	  Delete(SwigType_pop(ty));
-	}
-	Delete(SwigType_pop_function(ty));
-	Setattr(m, "returntype", ty);
-
-	String *mname = NewStringf("%s::%s", Getattr(parent, "name"), name);
-	/* apply the features of the original method found in the base class */
-	Swig_features_get(Swig_cparse_features(), 0, mname, Getattr(m, "decl"), m);
-	Setattr(item, "methodNode", m);
-	Setattr(item, "vmid", method_id);
-	if (replace == DO_NOT_REPLACE)
-	  Append(vm, item);
-	else
-	  Setitem(vm, replace, item);
-	Setattr(nn, "directorNode", m);
-
-	Delete(mname);
+	Hash *entry = NewHash();
+	Setattr(entry, "node", nn);
+	Setattr(entry, "class", n);
+	Setattr(entry, "vmid", method_id);
+	Append(entries, entry);
+	Delete(entry);
+	Delete(method_id);
       }
       if (is_destructor) {
-	virtual_destructor = 1;
+	SetFlag(vtable, "virtual_destructor");
       }
     }
   }
+  Delete(entries);
+  Delete(vtable);
+  return vtable;
+}
+
+/* ----------------------------------------------------------------------
+ * Language::unrollVirtualMethods()
+ * ---------------------------------------------------------------------- */
+int Language::unrollVirtualMethods(Node *n, Node *parent, List *vm, int &virtual_destructor, int protectedbase) {
+  Hash *vtable = classVtable(n, protectedbase);
+  if (GetFlag(vtable, "virtual_destructor"))
+    virtual_destructor = 1;
+
+  /* index the vm entries by vmid so that overriding methods replace the existing entry */
+  Hash *vmids = NewHash();
+  for (int i = 0; i < Len(vm); i++)
+    SetInt(vmids, Getattr(Getitem(vm, i), "vmid"), i);
+
+  Iterator ei;
+  for (ei = First(Getattr(vtable, "entries")); ei.item; ei = Next(ei)) {
+    Node *nn = Getattr(ei.item, "node");
+    String *method_id = Getattr(ei.item, "vmid");
+    String *classname = Getattr(Getattr(ei.item, "class"), "name");
+    String *name = Getattr(nn, "name");
+    String *decl = Getattr(nn, "decl");
+    /* filling a new method item */
+    String *fqdname = NewStringf("%s::%s", classname, name);
+    Hash *item = NewHash();
+    Setattr(item, "fqdname", fqdname);
+    Node *m = Copy(nn);
+
+    /* Store the complete return type - needed for non-simple return types (pointers, references etc.) */
+    SwigType *ty = NewString(Getattr(m, "type"));
+    SwigType_push(ty, decl);
+    if (SwigType_isqualifier(ty)) {
+      Delete(SwigType_pop(ty));
+    }
+    Delete(SwigType_pop_function(ty));
+    Setattr(m, "returntype", ty);
+
+    String *mname = NewStringf("%s::%s", Getattr(parent, "name"), name);
+    /* apply the features of the original method found in the base class */
+    Swig_features_get(Swig_cparse_features(), 0, mname, Getattr(m, "decl"), m);
+    Setattr(item, "methodNode", m);
+    Setattr(item, "vmid", method_id);
+    /* Make sure that the new method overwrites the existing: */
+    if (Getattr(vmids, method_id)) {
+      Setitem(vm, GetInt(vmids, method_id), item);
+    } else {
+      SetInt(vmids, method_id, Len(vm));
+      Append(vm, item);
+    }
+    Setattr(nn, "directorNode", m);
+
+    Delete(mname);
+  }
+  Delete(vmids);
 
   /*
      We delete all the nodirector methods. This prevents the
@@ -2139,7 +2186,7 @@ int Language::classDirector(Node *n) {
   }
   List *vtable = NewList();
   int virtual_destructor = 0;
-  unrollVirtualMethods(n, n, vtable, 0, virtual_destructor);
+  unrollVirtualMethods(n, n, vtable, virtual_destructor);
 
   // Emit all the using base::member statements for non virtual members (allprotected mode)
   Node *ni;
@@ -2436,10 +2483,14 @@ int Language::classDeclaration(Node *n) {
     /* check for abstract after resolving directors */
     Abstract = abstractClassTest(n);
 
+    Swig_timing_start("class handling");
     classHandler(n);
+    Swig_timing_stop("class handling");
   } else {
     Abstract = abstractClassTest(n);
+    Swig_timing_start("class handling");
     Language::classHandler(n);
+    Swig_timing_stop("class handling");
   }
 
   NSpace = oldNSpace;
@@ -3582,6 +3633,10 @@ String *Language::defaultExternalRuntimeFilename() {
   return 0;
 }
 
+int Language::supportsOutputShards() {
+  return 0;
+}
+
 /* -----------------------------------------------------------------------------
  * Language::replaceSpecialVariables()
  * Language modules should implement this if special variables are to be handled
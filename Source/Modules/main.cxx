@@ -16,6 +16,10 @@
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <direct.h>
+#define getcwd _getcwd
+#else
+#include <unistd.h>
 #endif
 
 #include "swigmod.h"
@@ -24,6 +28,7 @@
 #include "cparse.h"
 #include <ctype.h>
 #include <limits.h>		// for INT_MAX
+#include <time.h>
 
 // Global variables
 
@@ -63,8 +68,9 @@ static const char *usage1 = (const char *) "\
      -cpperraswarn   - Treat the preprocessor #error statement as #warning (default)\n\
      -copyright      - Display copyright notices\n\
      -debug-classes  - Display information about the classes found in the interface\n\
+     -debug-file     - Display files opened and include path resolution statistics\n\
      -debug-module <n>- Display module parse tree at stages 1-4, <n> is a csv list of stages\n\
-     -debug-symtabs  - Display symbol tables information\n\
+     -debug-symtabs  - Display symbol tables information and symbol lookup cache statistics\n\
      -debug-symbols  - Display target language symbols in the symbol tables\n\
      -debug-csymbols - Display C symbols in the symbol tables\n\
      -debug-lsymbols - Display target language layer symbols\n\
@@ -72,6 +78,7 @@ static const char *usage1 = (const char *) "\
      -debug-template - Display information for debugging templates\n\
      -debug-top <n>  - Display entire parse tree at stages 1-4, <n> is a csv list of stages\n\
      -debug-typedef  - Display information about the types and typedefs in the interface\n\
+                       and typedef resolution cache statistics\n\
      -debug-typemap  - Display typemap debugging information\n\
      -debug-tmsearch - Display typemap search debugging information\n\
      -debug-tmused   - Display typemaps used debugging information\n\
@@ -92,6 +99,7 @@ static const char *usage2 = (const char *) "\
      -Fmicrosoft     - Display error/warning messages in Microsoft format\n\
      -Fstandard      - Display error/warning messages in commonly used format\n\
      -fvirtual       - Compile in virtual elimination mode\n\
+     -hash-benchmark - Time the DOH hash tables on the parse tree of the input file and exit\n\
      -help           - This output\n\
      -I-             - Don't search the current directory\n\
      -I<dir>         - Look for SWIG files in directory <dir>\n\
@@ -99,8 +107,10 @@ static const char *usage2 = (const char *) "\
      -importall      - Follow all #include statements as imports\n\
      -includeall     - Follow all #include statements\n\
      -l<ifile>       - Include SWIG library file <ifile>\n\
+     -libcache <dir> - Cache the preprocessed SWIG library files in directory <dir>\n\
      -macroerrors    - Report errors inside macros\n\
      -makedefault    - Create default constructors/destructors (the default)\n\
+     -manifest <file> - Skip regenerating if nothing recorded in <file> has changed\n\
      -M              - List all dependencies\n\
      -MD             - Is equivalent to `-M -MF <file>', except `-E' is not implied\n\
      -MF <file>      - Generate dependencies into <file> and continue generating wrappers\n\
@@ -128,10 +138,14 @@ static const char *usage3 = (const char *) "\
      -oh <headfile>  - Set name of the output header file to <headfile>\n\
      -outcurrentdir  - Set default output dir to current dir instead of input file's path\n\
      -outdir <dir>   - Set language specific files output directory to <dir>\n\
+     -outshards <n>  - Split the C/C++ wrapper file into <n> files (Java, C# and Objective-C)\n\
      -pcreversion    - Display PCRE version information\n\
      -small          - Compile in virtual elimination & compact mode\n\
+     -scanner-benchmark - Time the C/C++ scanner over the input file and exit\n\
      -swiglib        - Report location of SWIG library and exit\n\
      -templatereduce - Reduce all the typedefs in templates\n\
+     -timing         - Display time, memory and allocations for each processing phase\n\
+     -timing-json <file> - Write the -timing information to <file> in JSON format\n\
      -v              - Run in verbose mode\n\
      -version        - Display SWIG version number\n\
      -Wall           - Remove all warning suppression, also implies -Wextra\n\
@@ -139,6 +153,7 @@ static const char *usage3 = (const char *) "\
      -Werror         - Treat warnings as errors\n\
      -Wextra         - Adds the following additional warnings: " EXTRA_WARNINGS "\n\
      -w<list>        - Suppress/add warning messages, eg -w401,+321 - see Warnings.html\n\
+     -write-if-changed - Only replace output files whose contents have changed\n\
      -xmlout <file>  - Write XML version of the parse tree to <file> after normal processing\n\
 \n\
 Options can also be defined using the SWIG_FEATURES environment variable, for example:\n\
@@ -165,6 +180,7 @@ static char *depends_extension = (char *) "d";
 static String *outdir = 0;
 static String *xmlout = 0;
 static int outcurrentdir = 0;
+static int output_shards = 1;
 static int help = 0;
 static int checkout = 0;
 static int cpp_only = 0;
@@ -172,6 +188,8 @@ static int no_cpp = 0;
 static String *outfile_name = 0;
 static String *outfile_name_h = 0;
 static int tm_debug = 0;
+static int tm_search_debug = 0;
+static int file_debug = 0;
 static int dump_symtabs = 0;
 static int dump_symbols = 0;
 static int dump_csymbols = 0;
@@ -188,6 +206,13 @@ static int depend = 0;
 static int depend_only = 0;
 static int depend_phony = 0;
 static int memory_debug = 0;
+static int timing = 0;
+static int scanner_benchmark = 0;
+static int hash_benchmark = 0;
+static int write_if_changed = 0;
+static String *libcache = 0;
+static String *manifest_file = 0;
+static String *timing_json = 0;
 static int allkw = 0;
 static DOH *cpps = 0;
 static String *dependencies_file = 0;
@@ -331,6 +356,36 @@ List *SWIG_output_files() {
   return all_output_files;
 }
 
+// Returns the number of files the C/C++ wrapper code is split into (-outshards)
+int SWIG_output_shards() {
+  return output_shards;
+}
+
+/* -----------------------------------------------------------------------------
+ * SWIG_output_shard_filename()
+ *
+ * Returns the name of one of the files the wrapper file 'outfile' is split into
+ * by -outshards.  Shard 0 keeps the name of the wrapper file, shard i is written
+ * to <outfile>_i.<ext>.  A negative shard number gives the name of the header
+ * with the code common to all the shards, <outfile>_common.<hpp_extension>.
+ * ----------------------------------------------------------------------------- */
+
+String *SWIG_output_shard_filename(const String *outfile, int shard) {
+  if (shard == 0)
+    return NewString(outfile);
+  const char *name = Char(outfile);
+  const char *ext = strrchr(name, '.');
+  const char *delim = strrchr(name, *SWIG_FILE_DELIMITER);
+  if (!ext || (delim && ext < delim))
+    ext = name + strlen(name);
+  String *filename = NewStringWithSize(name, (int)(ext - name));
+  if (shard < 0)
+    Printf(filename, "_common.%s", hpp_extension);
+  else
+    Printf(filename, "_%d%s", shard, ext);
+  return filename;
+}
+
 void SWIG_setfeature(const char *cfeature, const char *cvalue) {
   Hash *features_hash = Swig_cparse_features();
   String *name = NewString("");
@@ -447,6 +502,336 @@ static void SWIG_dump_runtime() {
   SWIG_exit(EXIT_SUCCESS);
 }
 
+/* -----------------------------------------------------------------------------
+ * SWIG_scanner_benchmark()
+ *
+ * Handles the -scanner-benchmark option.  The input file is read without
+ * preprocessing and split into tokens by the same scanner the parser uses,
+ * repeatedly for at least a second, and the throughput is reported.
+ * Tools/scanner-benchmark.sh runs this over the whole SWIG library.
+ * ----------------------------------------------------------------------------- */
+
+static void SWIG_scanner_benchmark(String *filename) {
+  Scanner *scan;
+  String *contents;
+  FILE *f = Swig_open(filename);
+  long bytes = 0;
+  long tokens = 0;
+  int passes = 0;
+  clock_t start, elapsed;
+  double seconds;
+
+  if (!f) {
+    FileErrorDisplay(filename);
+    SWIG_exit(EXIT_FAILURE);
+  }
+  contents = Swig_read_file(f);
+  fclose(f);
+
+  scan = NewScanner();
+  Scanner_idstart(scan, "%");
+  start = clock();
+  do {
+    String *text = Copy(contents);
+    Seek(text, 0, SEEK_SET);
+    Setline(text, 1);
+    Scanner_clear(scan);
+    Scanner_push(scan, text);
+    Delete(text);
+    while (Scanner_token(scan))
+      tokens++;
+    bytes += Len(contents);
+    passes++;
+    elapsed = clock() - start;
+  } while (elapsed < CLOCKS_PER_SEC);
+  DelScanner(scan);
+  Delete(contents);
+
+  seconds = (double) elapsed / CLOCKS_PER_SEC;
+  Printf(stdout, "Scanned %ld bytes, %ld tokens in %d passes over '%s'\n", bytes, tokens, passes, filename);
+  Printf(stdout, "%.3f seconds, %.2f MB/s, %.0f tokens/s\n", seconds, (double) bytes / (1024.0 * 1024.0) / seconds, (double) tokens / seconds);
+  SWIG_exit(EXIT_SUCCESS);
+}
+
+/* -----------------------------------------------------------------------------
+ * SWIG_hash_benchmark()
+ *
+ * Handles the -hash-benchmark option.  The attributes of every node in the
+ * parse tree, and of the parameters of every node, are copied out and the
+ * tables are then rebuilt repeatedly for at least a second with each of the
+ * DOH Hash implementations.  Each pass times building the tables, looking up
+ * every attribute by name, looking up attributes most nodes do not have,
+ * iterating and copying.  Tools/hash-benchmark.sh runs this over a few
+ * interfaces from the test-suite.
+ * ----------------------------------------------------------------------------- */
+
+static void hash_benchmark_dump(Node *n, List *records) {
+  for (; n; n = nextSibling(n)) {
+    List *record = NewList();
+    for (Iterator ki = First(n); ki.key; ki = Next(ki)) {
+      Append(record, ki.key);
+      Append(record, ki.item);
+    }
+    Append(records, record);
+    Delete(record);
+    for (Parm *p = Getattr(n, "parms"); p; p = nextSibling(p)) {
+      record = NewList();
+      for (Iterator ki = First(p); ki.key; ki = Next(ki)) {
+	Append(record, ki.key);
+	Append(record, ki.item);
+      }
+      Append(records, record);
+      Delete(record);
+    }
+    hash_benchmark_dump(firstChild(n), records);
+  }
+}
+
+static void SWIG_hash_benchmark(Node *top) {
+  static const char *missing[] = { "feature:ignore", "feature:immutable", "sym:weak", "hidden", "error", "abstracts", "template", "code", 0 };
+  static const struct {
+    const char *name;
+    DOH *(*create)(void);
+  } tables[] = { { "chained", DohNewChainedHash }, { "open", DohNewHash } };
+  enum { BUILD, HIT, MISS, ITERATE, COPY, NPHASES };
+  static const char *phases[NPHASES] = { "build", "hit", "miss", "iterate", "copy" };
+  List *records = NewList();
+  int nrecords, nentries = 0;
+  int nkeys[NPHASES];
+
+  hash_benchmark_dump(top, records);
+  nrecords = Len(records);
+  for (int r = 0; r < nrecords; r++)
+    nentries += Len(Getitem(records, r)) / 2;
+  nkeys[BUILD] = nkeys[HIT] = nkeys[ITERATE] = nkeys[COPY] = nentries;
+  nkeys[MISS] = nrecords * (int) (sizeof(missing) / sizeof(missing[0]) - 1);
+  Printf(stdout, "%d tables with %d entries in the parse tree\n", nrecords, nentries);
+
+  DOH **hashes = (DOH **) malloc(nrecords * sizeof(DOH *));
+  for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+    clock_t elapsed[NPHASES] = { 0, 0, 0, 0, 0 };
+    clock_t total = 0;
+    int passes = 0;
+    long found = 0;
+    do {
+      clock_t start = clock();
+      for (int r = 0; r < nrecords; r++) {
+	List *record = Getitem(records, r);
+	int len = Len(record);
+	DOH *h = tables[t].create();
+	for (int i = 0; i < len; i += 2)
+	  Setattr(h, Getitem(record, i), Getitem(record, i + 1));
+	hashes[r] = h;
+      }
+      clock_t now = clock();
+      elapsed[BUILD] += now - start;
+      start = now;
+      for (int r = 0; r < nrecords; r++) {
+	List *record = Getitem(records, r);
+	int len = Len(record);
+	for (int i = 0; i < len; i += 2)
+	  found += Getattr(hashes[r], Char(Getitem(record, i))) != 0;
+      }
+      now = clock();
+      elapsed[HIT] += now - start;
+      start = now;
+      for (int r = 0; r < nrecords; r++) {
+	for (const char **m = missing; *m; m++)
+	  found += Getattr(hashes[r], *m) != 0;
+      }
+      now = clock();
+      elapsed[MISS] += now - start;
+      start = now;
+      for (int r = 0; r < nrecords; r++) {
+	for (Iterator ki = First(hashes[r]); ki.key; ki = Next(ki))
+	  found++;
+      }
+      now = clock();
+      elapsed[ITERATE] += now - start;
+      start = now;
+      for (int r = 0; r < nrecords; r++) {
+	DOH *copy = Copy(hashes[r]);
+	Delete(copy);
+	Delete(hashes[r]);
+      }
+      now = clock();
+      elapsed[COPY] += now - start;
+      total = elapsed[BUILD] + elapsed[HIT] + elapsed[MISS] + elapsed[ITERATE] + elapsed[COPY];
+      passes++;
+    } while (total < CLOCKS_PER_SEC);
+
+    Printf(stdout, "%-8s %d passes, %.3f seconds, ns per entry:", tables[t].name, passes, (double) total / CLOCKS_PER_SEC);
+    for (int p = 0; p < NPHASES; p++)
+      Printf(stdout, " %s %.1f", phases[p], (double) elapsed[p] / CLOCKS_PER_SEC * 1e9 / ((double) passes * nkeys[p]));
+    Printf(stdout, "\n");
+  }
+  free(hashes);
+  Delete(records);
+  SWIG_exit(EXIT_SUCCESS);
+}
+
+/* -----------------------------------------------------------------------------
+ * manifest_*()
+ *
+ * Support for -manifest <file>.  After a successful run the manifest records
+ * the command line, the search path, the size and a hash of the contents of
+ * every input and output file and every file looked for in the search path but
+ * not found.  A later run with the same manifest checks these first and skips
+ * regenerating everything if nothing has changed, which includes none of the
+ * missing files having appeared.  The manifest is a text file:
+ *
+ *     <key lines>
+ *     input <digest> <filename>
+ *     output <digest> <filename>
+ *     missing - <filename>
+ * ----------------------------------------------------------------------------- */
+
+static String *manifest_digest(const_String_or_char_ptr filename) {
+  FILE *f = fopen(Char(filename), "rb");
+  if (!f)
+    return 0;
+  unsigned long h1 = 2166136261UL;
+  unsigned long h2 = 5381UL;
+  unsigned long size = 0;
+  unsigned char buffer[8192];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      h1 = ((h1 ^ buffer[i]) * 16777619UL) & 0xffffffffUL;
+      h2 = ((h2 << 5) + h2 + buffer[i]) & 0xffffffffUL;
+    }
+    size += (unsigned long)n;
+  }
+  int error = ferror(f);
+  fclose(f);
+  if (error)
+    return 0;
+  char digest[64];
+  sprintf(digest, "%lu:%08lx%08lx", size, h1, h2);
+  return NewString(digest);
+}
+
+static String *manifest_key(int argc, char *argv[]) {
+  char cwd[4096];
+  String *key = NewStringf("SWIG manifest %s\n", Swig_package_version());
+  Printf(key, "lib %s\n", SwigLib);
+  Printf(key, "cwd %s\n", getcwd(cwd, sizeof(cwd)) ? cwd : "");
+  for (int i = 1; i < argc; i++)
+    Printf(key, "arg %s\n", argv[i]);
+  List *spath = Swig_search_path();
+  for (int i = 0; i < Len(spath); i++)
+    Printf(key, "path %s\n", Getitem(spath, i));
+  Delete(spath);
+  return key;
+}
+
+// Returns 1 if the manifest was written with the same key and none of the files it lists have changed since
+static int manifest_check(String *key, List *outputs) {
+  FILE *f = fopen(Char(manifest_file), "r");
+  if (!f)
+    return 0;
+  String *contents = Swig_read_file(f);
+  fclose(f);
+  int uptodate = Strncmp(contents, key, Len(key)) == 0;
+  int noutputs = 0;
+  if (uptodate) {
+    String *entries = NewString(Char(contents) + Len(key));
+    List *lines = SplitLines(entries);
+    for (int i = 0; uptodate && i < Len(lines); i++) {
+      const char *line = Char(Getitem(lines, i));
+      const char *digest = strchr(line, ' ');
+      const char *filename = digest ? strchr(digest + 1, ' ') : 0;
+      if (!*line)
+	continue;
+      if (!filename) {
+	uptodate = 0;
+	break;
+      }
+      if (strncmp(line, "missing ", 8) == 0) {
+	FILE *missing = fopen(filename + 1, "r");
+	if (missing) {
+	  fclose(missing);
+	  uptodate = 0;
+	}
+	continue;
+      }
+      String *expected = NewStringWithSize(digest + 1, (int)(filename - digest - 1));
+      String *actual = manifest_digest(filename + 1);
+      uptodate = actual && Equal(actual, expected);
+      if (strncmp(line, "output ", 7) == 0) {
+	Append(outputs, filename + 1);
+	noutputs++;
+      } else if (strncmp(line, "input ", 6) != 0) {
+	uptodate = 0;
+      }
+      Delete(actual);
+      Delete(expected);
+    }
+    Delete(lines);
+    Delete(entries);
+  }
+  Delete(contents);
+  return uptodate && noutputs > 0;
+}
+
+static void manifest_add(String *manifest, Hash *seen, const char *tag, String *filename) {
+  if (Getattr(seen, filename))
+    return;
+  String *digest = manifest_digest(filename);
+  if (digest) {
+    Printf(manifest, "%s %s %s\n", tag, digest, filename);
+    Setattr(seen, filename, "1");
+    Delete(digest);
+  }
+}
+
+static void manifest_save(String *key) {
+  String *manifest = Copy(key);
+  Hash *seen = NewHash();
+  List *depends = Preprocessor_depend();
+  manifest_add(manifest, seen, "input", input_file);
+  for (int i = 0; i < Len(Swig_opened_files()); i++)
+    manifest_add(manifest, seen, "input", Getitem(Swig_opened_files(), i));
+  for (int i = 0; depends && i < Len(depends); i++)
+    manifest_add(manifest, seen, "input", Getitem(depends, i));
+  for (int i = 0; i < Len(all_output_files); i++)
+    manifest_add(manifest, seen, "output", Getitem(all_output_files, i));
+  for (int i = 0; i < Len(Swig_missing_files()); i++) {
+    String *missing = Getitem(Swig_missing_files(), i);
+    if (!Getattr(seen, missing)) {
+      Printf(manifest, "missing - %s\n", missing);
+      Setattr(seen, missing, "1");
+    }
+  }
+  File *f_manifest = NewFile(manifest_file, "w", 0);
+  if (!f_manifest) {
+    FileErrorDisplay(manifest_file);
+    SWIG_exit(EXIT_FAILURE);
+  }
+  Printf(f_manifest, "%s", manifest);
+  Delete(f_manifest);
+  Delete(seen);
+  Delete(manifest);
+}
+
+/* Writes the list of output files to the file named by the CCACHE_OUTFILES environment variable */
+static void write_ccache_outfiles() {
+  char *outfiles = getenv("CCACHE_OUTFILES");
+  if (outfiles) {
+    File *f_outfiles = NewFile(outfiles, "w", 0);
+    if (!f_outfiles) {
+      Printf(stderr, "Failed to write list of output files to the filename '%s' specified in CCACHE_OUTFILES environment variable - ", outfiles);
+      FileErrorDisplay(outfiles);
+      SWIG_exit(EXIT_FAILURE);
+    } else {
+      int i;
+      for (i = 0; i < Len(all_output_files); i++)
+        Printf(f_outfiles, "%s\n", Getitem(all_output_files, i));
+      Delete(f_outfiles);
+    }
+  }
+}
+
 void SWIG_getoptions(int argc, char *argv[]) {
   int i;
   // Get options
@@ -642,6 +1027,25 @@ void SWIG_getoptions(int argc, char *argv[]) {
 	fprintf(stdout, "Copyright (c) 2005-2006\n");
 	fprintf(stdout, "Arizona Board of Regents (University of Arizona)\n");
 	SWIG_exit(EXIT_SUCCESS);
+      } else if (strcmp(argv[i], "-libcache") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  libcache = NewString(argv[i + 1]);
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
+      } else if (strcmp(argv[i], "-manifest") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  manifest_file = NewString(argv[i + 1]);
+	  Swig_mark_arg(i + 1);
+	  // Output files must be complete on disk before their contents are recorded
+	  write_if_changed = 1;
+	  DohFileWriteIfChanged(1);
+	} else {
+	  Swig_arg_error();
+	}
       } else if (strncmp(argv[i], "-l", 2) == 0) {
 	// Add a new directory search path
 	Append(libfiles, argv[i] + 2);
@@ -680,6 +1084,11 @@ void SWIG_getoptions(int argc, char *argv[]) {
 	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-debug-tmsearch") == 0) {
 	Swig_typemap_search_debug_set();
+	tm_search_debug = 1;
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-debug-file") == 0) {
+	Swig_file_debug_set();
+	file_debug = 1;
 	Swig_mark_arg(i);
       } else if (strcmp(argv[i], "-debug-tmused") == 0) {
 	Swig_typemap_used_debug_set();
@@ -739,6 +1148,18 @@ void SWIG_getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-outcurrentdir") == 0) {
 	Swig_mark_arg(i);
 	outcurrentdir = 1;
+      } else if (strcmp(argv[i], "-outshards") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  output_shards = atoi(argv[i + 1]);
+	  if (output_shards < 1) {
+	    Printf(stderr, "Invalid number of output shards '%s'.\n", argv[i + 1]);
+	    SWIG_exit(EXIT_FAILURE);
+	  }
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
       } else if (strcmp(argv[i], "-Wall") == 0) {
 	Swig_mark_arg(i);
 	Swig_warnall();
@@ -751,6 +1172,10 @@ void SWIG_getoptions(int argc, char *argv[]) {
       } else if (strcmp(argv[i], "-Wextra") == 0) {
 	Swig_mark_arg(i);
         Swig_warnfilter(EXTRA_WARNINGS, 0);
+      } else if (strcmp(argv[i], "-write-if-changed") == 0) {
+	write_if_changed = 1;
+	DohFileWriteIfChanged(1);
+	Swig_mark_arg(i);
       } else if (strncmp(argv[i], "-w", 2) == 0) {
 	Swig_mark_arg(i);
 	Swig_warnfilter(argv[i] + 2, 1);
@@ -834,6 +1259,25 @@ void SWIG_getoptions(int argc, char *argv[]) {
       } else if ((strcmp(argv[i], "-debug-memory") == 0) || (strcmp(argv[i], "-dump_memory") == 0)) {
 	memory_debug = 1;
 	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-scanner-benchmark") == 0) {
+	scanner_benchmark = 1;
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-hash-benchmark") == 0) {
+	hash_benchmark = 1;
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-timing") == 0) {
+	timing = 1;
+	Swig_timing_enable();
+	Swig_mark_arg(i);
+      } else if (strcmp(argv[i], "-timing-json") == 0) {
+	Swig_mark_arg(i);
+	if (argv[i + 1]) {
+	  timing_json = NewString(argv[i + 1]);
+	  Swig_timing_enable();
+	  Swig_mark_arg(i + 1);
+	} else {
+	  Swig_arg_error();
+	}
       } else if (strcmp(argv[i], "-Fstandard") == 0) {
 	Swig_error_msg_format(EMF_STANDARD);
 	Swig_mark_arg(i);
@@ -861,6 +1305,7 @@ void SWIG_getoptions(int argc, char *argv[]) {
 
 int SWIG_main(int argc, char *argv[], Language *l) {
   char *c;
+  String *manifest_key_string = 0;
 
   /* Initialize the SWIG core */
   Swig_init();
@@ -939,6 +1384,11 @@ int SWIG_main(int argc, char *argv[], Language *l) {
   // Parse language dependent options
   lang->main(argc, argv);
 
+  if (output_shards > 1 && !lang->supportsOutputShards()) {
+    Printf(stderr, "The -outshards option is not supported by this target language.\n");
+    SWIG_exit(EXIT_FAILURE);
+  }
+
   if (help) {
     Printf(stdout, "\nNote: 'swig -<lang> -help' displays options for a specific target language.\n\n");
     SWIG_exit(EXIT_SUCCESS);	// Exit if we're in help mode
@@ -987,6 +1437,9 @@ int SWIG_main(int argc, char *argv[], Language *l) {
   input_file = NewString(argv[argc - 1]);
   Swig_filename_correct(input_file);
 
+  if (scanner_benchmark)
+    SWIG_scanner_benchmark(input_file);
+
   // If the user has requested to check out a file, handle that
   if (checkout) {
     DOH *s;
@@ -1019,9 +1472,21 @@ int SWIG_main(int argc, char *argv[], Language *l) {
       }
     }
   } else {
+    if (manifest_file && !cpp_only && !depend_only) {
+      manifest_key_string = manifest_key(argc, argv);
+      if (manifest_check(manifest_key_string, all_output_files)) {
+	if (Verbose)
+	  Printf(stdout, "Nothing to do, '%s' is up to date.\n", manifest_file);
+	write_ccache_outfiles();
+	SWIG_exit(EXIT_SUCCESS);
+      }
+      Clear(all_output_files);
+    }
+
     // Run the preprocessor
     if (Verbose)
       Printf(stdout, "Preprocessing...\n");
+    Swig_timing_phase("preprocess");
 
     {
       int i;
@@ -1043,6 +1508,7 @@ int SWIG_main(int argc, char *argv[], Language *l) {
 	}
       }
       if (!no_cpp) {
+	String *input_path = Copy(Swig_last_file());
 	fclose(df);
 	Printf(fs, "%%include <swig.swg>\n");
 	if (allkw) {
@@ -1051,12 +1517,25 @@ int SWIG_main(int argc, char *argv[], Language *l) {
 	if (lang_config) {
 	  Printf(fs, "\n%%include <%s>\n", lang_config);
 	}
-	Printf(fs, "%%include(maininput=\"%s\") \"%s\"\n", Swig_filename_escape(input_file), Swig_filename_escape(Swig_last_file()));
+	if (libcache) {
+	  // The library files above are the same for every interface file, preprocess them on their own so the result can be cached
+	  Seek(fs, 0, SEEK_SET);
+	  cpps = Preprocessor_parse_cached(fs, libcache);
+	  Clear(fs);
+	}
+	Printf(fs, "%%include(maininput=\"%s\") \"%s\"\n", Swig_filename_escape(input_file), Swig_filename_escape(input_path));
 	for (i = 0; i < Len(libfiles); i++) {
 	  Printf(fs, "\n%%include \"%s\"\n", Swig_filename_escape(Getitem(libfiles, i)));
 	}
 	Seek(fs, 0, SEEK_SET);
-	cpps = Preprocessor_parse(fs);
+	if (cpps) {
+	  String *s = Preprocessor_parse(fs);
+	  Append(cpps, s);
+	  Delete(s);
+	} else {
+	  cpps = Preprocessor_parse(fs);
+	}
+	Delete(input_path);
 	Delete(fs);
       } else {
 	cpps = Swig_read_file(df);
@@ -1103,7 +1582,18 @@ int SWIG_main(int argc, char *argv[], Language *l) {
 	  if (dependencies_target) {
 	    Printf(f_dependencies_file, "%s: ", dependencies_target);
 	  } else {
-	    Printf(f_dependencies_file, "%s: ", outfile);
+	    Printf(f_dependencies_file, "%s", outfile);
+	    for (int shard = 1; shard < output_shards; shard++) {
+	      String *shard_filename = SWIG_output_shard_filename(outfile, shard);
+	      Printf(f_dependencies_file, " %s", shard_filename);
+	      Delete(shard_filename);
+	    }
+	    if (output_shards > 1) {
+	      String *common_filename = SWIG_output_shard_filename(outfile, -1);
+	      Printf(f_dependencies_file, " %s", common_filename);
+	      Delete(common_filename);
+	    }
+	    Printf(f_dependencies_file, ": ");
 	  }
 	  List *files = Preprocessor_depend();
 	  List *phony_targets = NewList();
@@ -1151,6 +1641,7 @@ int SWIG_main(int argc, char *argv[], Language *l) {
       fflush(stdout);
     }
 
+    Swig_timing_phase("parse");
     Node *top = Swig_cparse(cpps);
 
     if (dump_top & STAGE1) {
@@ -1165,6 +1656,7 @@ int SWIG_main(int argc, char *argv[], Language *l) {
     if (Verbose) {
       Printf(stdout, "Processing types...\n");
     }
+    Swig_timing_phase("types");
     Swig_process_types(top);
 
     if (dump_top & STAGE2) {
@@ -1179,7 +1671,12 @@ int SWIG_main(int argc, char *argv[], Language *l) {
     if (Verbose) {
       Printf(stdout, "C++ analysis...\n");
     }
+    Swig_timing_phase("allocators");
     Swig_default_allocators(top);
+    Swig_timing_phase(0);
+
+    if (hash_benchmark)
+      SWIG_hash_benchmark(top);
 
     if (dump_top & STAGE3) {
       Printf(stdout, "debug-top stage 3\n");
@@ -1264,7 +1761,9 @@ int SWIG_main(int argc, char *argv[], Language *l) {
 	// Check the extension for a c/c++ file.  If so, we're going to declare everything we see as "extern"
 	ForceExtern = check_extension(input_file);
 
+	Swig_timing_phase("emit");
 	lang->top(top);
+	Swig_timing_phase(0);
 
 	if (browse) {
 	  Swig_browser(top, 0);
@@ -1293,24 +1792,46 @@ int SWIG_main(int argc, char *argv[], Language *l) {
   }
   if (tm_debug)
     Swig_typemap_debug();
+  if (tm_search_debug)
+    Swig_typemap_search_debug_statistics();
+  if (file_debug)
+    Swig_file_debug_statistics();
+  if (dump_symtabs)
+    Swig_symbol_print_statistics();
+  if (dump_typedef)
+    SwigType_typedef_print_statistics();
   if (memory_debug)
     DohMemoryDebug();
-
-  char *outfiles = getenv("CCACHE_OUTFILES");
-  if (outfiles) {
-    File *f_outfiles = NewFile(outfiles, "w", 0);
-    if (!f_outfiles) {
-      Printf(stderr, "Failed to write list of output files to the filename '%s' specified in CCACHE_OUTFILES environment variable - ", outfiles);
-      FileErrorDisplay(outfiles);
+  if (timing)
+    Swig_timing_report(stdout, 0);
+  if (timing_json) {
+    FILE *f_timing = fopen(Char(timing_json), "w");
+    if (!f_timing) {
+      FileErrorDisplay(timing_json);
       SWIG_exit(EXIT_FAILURE);
-    } else {
-      int i;
-      for (i = 0; i < Len(all_output_files); i++)
-        Printf(f_outfiles, "%s\n", Getitem(all_output_files, i));
-      Delete(f_outfiles);
     }
+    Swig_timing_report(f_timing, 1);
+    fclose(f_timing);
   }
 
+  if (write_if_changed) {
+    DohFileCommitPending();
+    if (Verbose) {
+      int changed = 0;
+      int unchanged = 0;
+      DohFileStatistics(&changed, &unchanged);
+      Printf(stdout, "Output files: %d changed, %d unchanged\n", changed, unchanged);
+    }
+  }
+
+  if (manifest_key_string) {
+    if (Swig_error_count() == 0 && !(werror && Swig_warn_count()))
+      manifest_save(manifest_key_string);
+    Delete(manifest_key_string);
+  }
+
+  write_ccache_outfiles();
+
   // Deletes
   Delete(libfiles);
   Preprocessor_delete();
@@ -142,6 +142,7 @@ public:
     
     virtual void main(int argc, char *argv[]);
     virtual int top(Node *n);
+    virtual int supportsOutputShards();
 
     String *getOverloadedName(Node *n);
     
@@ -333,10 +334,15 @@ int OBJECTIVEC::top(Node *n) {
         SWIG_exit(EXIT_FAILURE);
     }
     String *wrapfile_mm = NewString(outfile);
-    f_wrap_mm = NewFile(wrapfile_mm, "w", SWIG_output_files());
-    if (!f_wrap_mm) {
-        FileErrorDisplay(wrapfile_mm);
-        SWIG_exit(EXIT_FAILURE);
+    if (SWIG_output_shards() > 1) {
+        // Becomes the header common to all the shards written by Swig_shards_write()
+        f_wrap_mm = NewString("");
+    } else {
+        f_wrap_mm = NewFile(wrapfile_mm, "w", SWIG_output_files());
+        if (!f_wrap_mm) {
+            FileErrorDisplay(wrapfile_mm);
+            SWIG_exit(EXIT_FAILURE);
+        }
     }
     Delete(wrapfile_h);
     Delete(wrapfile_mm);
@@ -435,8 +441,10 @@ int OBJECTIVEC::top(Node *n) {
         Printf(f_directors, "/* ---------------------------------------------------\n");
         Printf(f_directors, " * C++ director class methods\n");
         Printf(f_directors, " * --------------------------------------------------- */\n\n");
-        Printf(f_directors, "#include <objc/runtime.h>\n");
-        Printf(f_directors, "#include \"%s_wrap.h\"\n\n", module);
+        if (SWIG_output_shards() <= 1) {
+            Printf(f_directors, "#include <objc/runtime.h>\n");
+            Printf(f_directors, "#include \"%s_wrap.h\"\n\n", module);
+        }
     }
 
     
@@ -452,9 +460,30 @@ int OBJECTIVEC::top(Node *n) {
     Dump(f_runtime, f_wrap_mm);
     Dump(f_header, f_wrap_mm);
 
+    if (SWIG_output_shards() > 1) {
+        if (directorsEnabled()) {
+            Printf(f_wrap_mm, "\n#include <objc/runtime.h>\n");
+            Printf(f_wrap_mm, "#include \"%s_wrap.h\"\n", module);
+        }
+        String *primary = NewString("");
+        if (Len(f_wrappers) > 0 || Len(f_init) > 0) {
+            Printf(primary, "\n#ifdef __cplusplus\n");
+            Printf(primary, "extern \"C\" {\n");
+            Printf(primary, "#endif\n\n");
+            Dump(f_wrappers, primary);
+            Wrapper_pretty_print(f_init, primary);
+            Printf(primary, "\n#ifdef __cplusplus\n");
+            Printf(primary, "}\n");
+            Printf(primary, "#endif\n");
+        }
+        Swig_shards_write(outfile, f_wrap_mm, f_directors, wrap_mm_code, primary, 1);
+        Delete(primary);
+    }
+
     // Copy director code
     if (directorsEnabled()) {
-        Dump(f_directors, f_wrap_mm);
+        if (SWIG_output_shards() <= 1)
+            Dump(f_directors, f_wrap_mm);
         Dump(f_directors_h, f_wrap_h);
 
         Delete(f_directors);
@@ -463,15 +492,17 @@ int OBJECTIVEC::top(Node *n) {
         f_directors_h = NULL;
     }
 
-    Printf(f_wrap_mm, "\n#ifdef __cplusplus\n");
-    Printf(f_wrap_mm, "extern \"C\" {\n");
-    Printf(f_wrap_mm, "#endif\n\n");
-    Dump(f_wrappers, f_wrap_mm);
-    Dump(wrap_mm_code, f_wrap_mm);
-    Wrapper_pretty_print(f_init, f_wrap_mm);
-    Printf(f_wrap_mm, "\n#ifdef __cplusplus\n");
-    Printf(f_wrap_mm, "}\n");
-    Printf(f_wrap_mm, "#endif\n");
+    if (SWIG_output_shards() <= 1) {
+        Printf(f_wrap_mm, "\n#ifdef __cplusplus\n");
+        Printf(f_wrap_mm, "extern \"C\" {\n");
+        Printf(f_wrap_mm, "#endif\n\n");
+        Dump(f_wrappers, f_wrap_mm);
+        Dump(wrap_mm_code, f_wrap_mm);
+        Wrapper_pretty_print(f_init, f_wrap_mm);
+        Printf(f_wrap_mm, "\n#ifdef __cplusplus\n");
+        Printf(f_wrap_mm, "}\n");
+        Printf(f_wrap_mm, "#endif\n");
+    }
 
     // Write to the wrap_h
     Printf(f_wrap_h, "\n#ifdef __cplusplus\n");
@@ -535,6 +566,14 @@ int OBJECTIVEC::top(Node *n) {
     return SWIG_OK;
 }
 
+/* -----------------------------------------------------------------------------
+* supportsOutputShards()
+* ----------------------------------------------------------------------------- */
+
+int OBJECTIVEC::supportsOutputShards() {
+    return 1;
+}
+
 /* -----------------------------------------------------------------------------
 * getOverloadedName()
 * ----------------------------------------------------------------------------- */
@@ -1131,6 +1170,7 @@ int OBJECTIVEC::functionWrapper(Node *n) {
     
     // Dump the function out.
     Wrapper_print(wrapper, wrap_mm_code);
+    Swig_shard_mark(wrap_mm_code);
     
     /* Create the proxy functions if proxy_flag is true. */
     if (proxy_flag && is_constructor) {	// Handle constructor
@@ -2685,6 +2725,7 @@ int OBJECTIVEC::classDirectorMethod(Node *n, Node *parent, String *super) {
         if (!Getattr(n, "defaultargs")) {
             Replaceall(w->code, "$symname", symname);
             Wrapper_print(w, f_directors);
+            Swig_shard_mark(f_directors);
             Printv(f_directors_h, declaration, NIL);
             Printv(f_directors_h, inline_extra_method, NIL);
         }
@@ -18,6 +18,11 @@
 
 #include "swigmod.h"
 #include <ctype.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 /* Module factories.  These functions are used to instantiate
    the built-in language modules.    If adding a new language
@@ -148,6 +153,113 @@ void SWIG_merge_envopt(const char *env, int oargc, char *oargv[], int *nargc, ch
   *nargv = argv;
 }
 
+//-----------------------------------------------------------------
+// split_languages()
+//
+// Handles more than one target language option, for example
+//
+//     swig -c++ -java -o java_wrap.cxx -csharp -o csharp_wrap.cxx example.i
+//
+// Options before the first target language option and the input file apply
+// to every language, options following a target language option only apply
+// to that language.  Options writing to a single named file (-manifest, -MF,
+// -timing-json, -xmlout) must follow a target language option so the
+// languages do not write the same file.  A process is forked for each language so the wrappers
+// are generated in parallel.  Each child returns with the arguments for its
+// language, the parent waits for all of them and exits.
+//-----------------------------------------------------------------
+
+static void split_languages(int *argc, char ***argv) {
+  int nlangs = 0;
+  int first = 0;
+  int i;
+
+  for (i = 1; i < *argc - 1; i++) {
+    if (Swig_find_module((*argv)[i])) {
+      if (!nlangs)
+	first = i;
+      nlangs++;
+    }
+  }
+  if (nlangs < 2)
+    return;
+
+  // Options naming a single output file would have every language write to it at once
+  static const char *single_file_options[] = { "-manifest", "-MF", "-timing-json", "-xmlout", 0 };
+  for (i = 1; i < first; i++) {
+    for (int j = 0; single_file_options[j]; j++) {
+      if (strcmp((*argv)[i], single_file_options[j]) == 0) {
+	Printf(stderr, "swig: Give %s after a target language option when generating more than one target language.\n", single_file_options[j]);
+	exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+#ifdef _WIN32
+  Printf(stderr, "swig: Multiple target languages are not supported on this platform.\n");
+  exit(EXIT_FAILURE);
+#else
+  char **args = *argv;
+  int nargs = *argc;
+  int start = first;
+  int nchildren = 0;
+  pid_t *children = new pid_t[nlangs];
+
+  fflush(stdout);
+  fflush(stderr);
+  while (start < nargs - 1) {
+    int end = start + 1;
+    int has_outfile = 0;
+    while (end < nargs - 1 && !Swig_find_module(args[end])) {
+      if (strcmp(args[end], "-o") == 0)
+	has_outfile = 1;
+      end++;
+    }
+    if (!has_outfile) {
+      Printf(stderr, "swig: Use -o after %s to name its wrapper file when generating more than one target language.\n", args[start]);
+      exit(EXIT_FAILURE);
+    }
+
+    // argv[0], the common options, this language's options and the input file
+    char **largv = new char *[first + (end - start) + 2];
+    int largc = 0;
+    for (i = 0; i < first; i++)
+      largv[largc++] = args[i];
+    for (i = start; i < end; i++)
+      largv[largc++] = args[i];
+    largv[largc++] = args[nargs - 1];
+    largv[largc] = 0;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      *argc = largc;
+      *argv = largv;
+      delete [] children;
+      return;
+    } else if (pid < 0) {
+      Printf(stderr, "swig: Unable to create a process for %s.\n", args[start]);
+      exit(EXIT_FAILURE);
+    }
+    delete [] largv;
+    children[nchildren++] = pid;
+    start = end;
+  }
+
+  int result = 0;
+  for (i = 0; i < nchildren; i++) {
+    int status;
+    if (waitpid(children[i], &status, 0) != children[i] || !WIFEXITED(status)) {
+      if (!result)
+	result = EXIT_FAILURE;
+    } else if (WEXITSTATUS(status) && !result) {
+      result = WEXITSTATUS(status);
+    }
+  }
+  delete [] children;
+  exit(result);
+#endif
+}
+
 int main(int margc, char **margv) {
   int i;
   Language *dl = 0;
@@ -168,6 +280,7 @@ int main(int margc, char **margv) {
     Swig_register_module(modules[i].name, modules[i].fac);
   }
 
+  split_languages(&argc, &argv);
   Swig_init_args(argc, argv);
 
   /* Get options */
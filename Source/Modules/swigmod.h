@@ -209,7 +209,7 @@ public:
   virtual int classDirector(Node *n);
   virtual int classDirectorInit(Node *n);
   virtual int classDirectorEnd(Node *n);
-  virtual int unrollVirtualMethods(Node *n, Node *parent, List *vm, int default_director, int &virtual_destructor, int protectedbase = 0);
+  virtual int unrollVirtualMethods(Node *n, Node *parent, List *vm, int &virtual_destructor, int protectedbase = 0);
   virtual int classDirectorConstructor(Node *n);
   virtual int classDirectorDefaultConstructor(Node *n);
   virtual int classDirectorMethod(Node *n, Node *parent, String *super);
@@ -229,6 +229,7 @@ public:
   virtual int is_assignable(Node *n);	/* Is variable assignable? */
   virtual String *runtimeCode();	/* returns the language specific runtime code */
   virtual String *defaultExternalRuntimeFilename();	/* the default filename for the external runtime */
+  virtual int supportsOutputShards();	/* can the wrapper file be split with -outshards? */
   virtual void replaceSpecialVariables(String *method, String *tm, Parm *parm); /* Language specific special variable substitutions for $typemap() */
 
   /* Runtime is C++ based, so extern "C" header section */
@@ -335,6 +336,8 @@ private:
   int cplus_runtime;
   int directors;
   static Language *this_;
+
+  Hash *classVtable(Node *n, int protectedbase);
 };
 
 int SWIG_main(int, char **, Language *);
@@ -349,6 +352,13 @@ void Swig_print_xml(Node *obj, String *filename);
 /* get the list of generated files */
 List *SWIG_output_files();
 
+/* splitting of the wrapper file into several files (-outshards) */
+int SWIG_output_shards();
+String *SWIG_output_shard_filename(const String *outfile, int shard);
+void Swig_shard_mark(String *code);
+void Swig_shard_shared(String *code, int start);
+void Swig_shards_write(const String *outfile, String *common, String *directors, String *wrappers, String *primary, int extern_c);
+
 void SWIG_library_directory(const char *);
 int emit_num_arguments(ParmList *);
 int emit_num_required(ParmList *);
@@ -104,6 +104,227 @@ void clean_overloaded(Node *n) {
   }
 }
 
+/* -----------------------------------------------------------------------------
+ * Shard marks
+ *
+ * The offsets recorded in a section by Swig_shard_mark() and Swig_shard_shared()
+ * are kept in a ShardMarks structure attached to the section as meta data.
+ * ----------------------------------------------------------------------------- */
+
+struct ShardMarks {
+  int nmarks;
+  int maxmarks;
+  int *marks;			/* Ends of the top level definitions */
+  int nshared;
+  int maxshared;
+  int *shared;			/* Start and end of each shared piece of code */
+};
+
+static void shard_marks_delete(void *ptr) {
+  ShardMarks *sm = (ShardMarks *) ptr;
+  free(sm->marks);
+  free(sm->shared);
+  free(sm);
+}
+
+static ShardMarks *shard_marks(String *code, int create) {
+  DOH *v = code ? Getmeta(code, "shard:marks") : 0;
+  if (!v) {
+    if (!create)
+      return 0;
+    ShardMarks *sm = (ShardMarks *) calloc(1, sizeof(ShardMarks));
+    v = NewVoid(sm, shard_marks_delete);
+    Setmeta(code, "shard:marks", v);
+    Delete(v);
+  }
+  return (ShardMarks *) Data(v);
+}
+
+static void shard_marks_append(int **offsets, int *count, int *max, int offset) {
+  if (*count == *max) {
+    *max = *max ? *max * 2 : 64;
+    *offsets = (int *) realloc(*offsets, *max * sizeof(int));
+  }
+  (*offsets)[(*count)++] = offset;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_shard_mark()
+ *
+ * Records the end of 'code' as a point at which it can be split across the files
+ * written by -outshards, that is, somewhere between two top level definitions.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_shard_mark(String *code) {
+  if (SWIG_output_shards() <= 1)
+    return;
+  ShardMarks *sm = shard_marks(code, 1);
+  shard_marks_append(&sm->marks, &sm->nmarks, &sm->maxmarks, Len(code));
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_shard_shared()
+ *
+ * Records the code from offset 'start' to the end of 'code' as needed by every
+ * file written by -outshards, such as the static helper functions in a %wrapper
+ * block, which may be used by wrappers that end up in any of the files.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_shard_shared(String *code, int start) {
+  if (SWIG_output_shards() <= 1 || !DohIsString(code))
+    return;
+  ShardMarks *sm = shard_marks(code, 1);
+  shard_marks_append(&sm->shared, &sm->nshared, &sm->maxshared, start);
+  shard_marks_append(&sm->shared, &sm->nshared, &sm->maxshared, Len(code));
+}
+
+/* -----------------------------------------------------------------------------
+ * shard_split()
+ *
+ * Splits 'code' into 'shards' pieces of about the same size at the points
+ * recorded by Swig_shard_mark().  Returns a list of 'shards' strings, some of
+ * which may be empty.  The code recorded by Swig_shard_shared() is left out of
+ * the pieces and appended to 'shared' instead.
+ * ----------------------------------------------------------------------------- */
+
+static List *shard_split(String *code, int shards, String *shared) {
+  List *pieces = NewList();
+  ShardMarks *sm = shard_marks(code, 0);
+  String *rest = NewStringEmpty();
+  int *marks = 0;
+  int nmarks = sm ? sm->nmarks : 0;
+  if (code) {
+    /* Move the shared code out, adjusting the marks following it */
+    const char *text = Char(code);
+    int pos = 0;
+    int m = 0;
+    if (nmarks) {
+      marks = (int *) malloc(nmarks * sizeof(int));
+      memcpy(marks, sm->marks, nmarks * sizeof(int));
+    }
+    for (int i = 0; sm && i < sm->nshared; i += 2) {
+      int start = sm->shared[i];
+      int end = sm->shared[i + 1];
+      for (; m < nmarks && marks[m] <= start; m++)
+	marks[m] -= pos - Len(rest);
+      Write(rest, text + pos, start - pos);
+      Write(shared, text + start, end - start);
+      pos = end;
+    }
+    for (; m < nmarks; m++)
+      marks[m] -= pos - Len(rest);
+    Write(rest, text + pos, Len(code) - pos);
+  }
+
+  const char *text = Char(rest);
+  int len = Len(rest);
+  int start = 0;
+  int m = 0;
+  for (int shard = 1; shard <= shards; shard++) {
+    int end = len;
+    if (shard < shards) {
+      double target = (double)len * shard / shards;
+      while (m < nmarks && marks[m] < target)
+	m++;
+      if (m < nmarks)
+	end = marks[m];
+      if (end < start)
+	end = start;
+    }
+    String *piece = NewStringWithSize(text + start, end - start);
+    Append(pieces, piece);
+    Delete(piece);
+    start = end;
+  }
+  free(marks);
+  Delete(rest);
+  return pieces;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_shards_write()
+ *
+ * Writes the C/C++ wrapper code split across SWIG_output_shards() files so that
+ * it can be compiled in parallel.  'common' holds the code needed by every shard,
+ * normally the begin, runtime and header sections, and goes into a header that
+ * each shard includes, followed by the code recorded by Swig_shard_shared().
+ * The director implementations in 'directors' and the wrapper functions in
+ * 'wrappers' are shared out evenly between the shards, the latter inside an
+ * extern "C" block if 'extern_c' is set.  'primary' is only written to the
+ * first shard, which keeps the name 'outfile'.
+ *
+ * Every shard defines SWIG_OUTSHARDS to the number of shards and the first one
+ * also defines SWIG_OUTSHARD_PRIMARY so that runtime code can define any state
+ * shared by the shards just once.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_shards_write(const String *outfile, String *common, String *directors, String *wrappers, String *primary, int extern_c) {
+  int shards = SWIG_output_shards();
+  String *common_filename = SWIG_output_shard_filename(outfile, -1);
+  File *f_common = NewFile(common_filename, "w", SWIG_output_files());
+  if (!f_common) {
+    FileErrorDisplay(common_filename);
+    SWIG_exit(EXIT_FAILURE);
+  }
+  String *directors_shared = NewStringEmpty();
+  String *wrappers_shared = NewStringEmpty();
+  List *director_pieces = shard_split(directors, shards, directors_shared);
+  List *wrapper_pieces = shard_split(wrappers, shards, wrappers_shared);
+  Dump(common, f_common);
+  Dump(directors_shared, f_common);
+  if (Len(wrappers_shared) > 0) {
+    if (extern_c) {
+      Printf(f_common, "\n#ifdef __cplusplus\n");
+      Printf(f_common, "extern \"C\" {\n");
+      Printf(f_common, "#endif\n\n");
+    }
+    Dump(wrappers_shared, f_common);
+    if (extern_c) {
+      Printf(f_common, "#ifdef __cplusplus\n");
+      Printf(f_common, "}\n");
+      Printf(f_common, "#endif\n");
+    }
+  }
+  Delete(f_common);
+
+  String *include = Swig_file_filename(common_filename);
+  for (int shard = 0; shard < shards; shard++) {
+    String *filename = SWIG_output_shard_filename(outfile, shard);
+    File *f_shard = NewFile(filename, "w", SWIG_output_files());
+    if (!f_shard) {
+      FileErrorDisplay(filename);
+      SWIG_exit(EXIT_FAILURE);
+    }
+    Swig_banner(f_shard);
+    Printf(f_shard, "\n#define SWIG_OUTSHARDS %d\n", shards);
+    if (shard == 0)
+      Printf(f_shard, "#define SWIG_OUTSHARD_PRIMARY\n");
+    Printf(f_shard, "#include \"%s\"\n\n", include);
+    Dump(Getitem(director_pieces, shard), f_shard);
+    if (extern_c) {
+      Printf(f_shard, "\n#ifdef __cplusplus\n");
+      Printf(f_shard, "extern \"C\" {\n");
+      Printf(f_shard, "#endif\n\n");
+    }
+    Dump(Getitem(wrapper_pieces, shard), f_shard);
+    if (extern_c) {
+      Printf(f_shard, "#ifdef __cplusplus\n");
+      Printf(f_shard, "}\n");
+      Printf(f_shard, "#endif\n");
+    }
+    if (shard == 0 && primary)
+      Dump(primary, f_shard);
+    Delete(f_shard);
+    Delete(filename);
+  }
+  Delete(wrapper_pieces);
+  Delete(director_pieces);
+  Delete(wrappers_shared);
+  Delete(directors_shared);
+  Delete(include);
+  Delete(common_filename);
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_set_max_hash_expand()
  *
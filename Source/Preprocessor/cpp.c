@@ -20,6 +20,17 @@
 #include "swig.h"
 #include "preprocessor.h"
 #include <ctype.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define getcwd _getcwd
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 static Hash *cpp = 0;		/* C preprocessor data */
 static int include_all = 0;	/* Follow all includes */
@@ -29,6 +40,8 @@ static int imported_depth = 0;	/* Depth of %imported files */
 static int single_include = 1;	/* Only include each file once */
 static Hash *included_files = 0;
 static List *dependencies = 0;
+static List *nowarn_pragmas = 0;	/* Arguments of all the #pragma SWIG nowarn= seen */
+static Hash *macro_lookups = 0;	/* Macros looked up by Preprocessor_parse_cached(), see macro_lookup() */
 static Scanner *id_scan = 0;
 static int error_as_warning = 0;	/* Understand the cpp #error directive as a special #warning */
 static int expand_defined_operator = 0;
@@ -43,6 +56,55 @@ static const String * macro_start_file = 0;
 #define isidchar(c) ((isalnum(c)) || (c == '_') || (c == '$'))
 
 static DOH *Preprocessor_replace(DOH *);
+static String *macro_describe(Hash *macro);
+
+/* Bloom filter over the names of all the macros defined so far, along with the
+   identifiers that Preprocessor_replace() treats specially.  Names are never
+   removed when a macro is undefined, which only costs an occasional needless
+   symbol table lookup.  See copy_plain_text(). */
+#define MACRO_FILTER_BITS (1 << 16)
+static unsigned char macro_filter[MACRO_FILTER_BITS / 8];
+
+static unsigned int macro_filter_hash(const char *name, int len) {
+  unsigned int h = 2166136261U;
+  int i;
+  for (i = 0; i < len; i++) {
+    h ^= (unsigned char) name[i];
+    h *= 16777619U;
+  }
+  return h;
+}
+
+static void macro_filter_add(const_String_or_char_ptr name) {
+  unsigned int h = macro_filter_hash(Char(name), Len(name));
+  unsigned int b1 = h % MACRO_FILTER_BITS;
+  unsigned int b2 = (h >> 16) % MACRO_FILTER_BITS;
+  macro_filter[b1 / 8] |= (unsigned char) (1 << (b1 % 8));
+  macro_filter[b2 / 8] |= (unsigned char) (1 << (b2 % 8));
+}
+
+static int macro_filter_test(const char *name, int len) {
+  unsigned int h = macro_filter_hash(name, len);
+  unsigned int b1 = h % MACRO_FILTER_BITS;
+  unsigned int b2 = (h >> 16) % MACRO_FILTER_BITS;
+  return (macro_filter[b1 / 8] & (1 << (b1 % 8))) && (macro_filter[b2 / 8] & (1 << (b2 % 8)));
+}
+
+/* Look up a macro in the symbol table.  Every lookup goes through here so that
+   Preprocessor_parse_cached() can record which macros the cached text depends on,
+   along with their definitions before it was preprocessed. */
+static Hash *macro_lookup(Hash *symbols, const DOH *name) {
+  Hash *macro = Getattr(symbols, name);
+  if (macro_lookups && !Getattr(macro_lookups, name)) {
+    /* Copy the name, the caller may reuse the string */
+    String *n = NewString(name);
+    String *d = macro_describe(macro);
+    Setattr(macro_lookups, n, d);
+    Delete(d);
+    Delete(n);
+  }
+  return macro;
+}
 
 /* Skip whitespace */
 static void skip_whitespace(String *s, String *out) {
@@ -192,6 +254,11 @@ void Preprocessor_init(void) {
   kpp_hash_if = NewString("#if");
   kpp_hash_elif = NewString("#elif");
 
+  memset(macro_filter, 0, sizeof(macro_filter));
+  macro_filter_add(kpp_defined);
+  macro_filter_add(kpp_LINE);
+  macro_filter_add(kpp_FILE);
+
   cpp = NewHash();
   s = NewHash();
   Setattr(cpp, kpp_symbols, s);
@@ -246,6 +313,7 @@ void Preprocessor_delete(void) {
   DelScanner(id_scan);
 
   Delete(dependencies);
+  Delete(nowarn_pragmas);
 
   Delete(Swig_add_directory(0));
 }
@@ -518,7 +586,7 @@ Hash *Preprocessor_define(const_String_or_char_ptr _str, int swigmacro) {
     Setattr(macro, kpp_swigmacro, "1");
   }
   symbols = Getattr(cpp, kpp_symbols);
-  if ((m1 = Getattr(symbols, macroname))) {
+  if ((m1 = macro_lookup(symbols, macroname))) {
     if (!Checkattr(m1, kpp_value, macrovalue)) {
       Swig_error(Getfile(macroname), Getline(macroname), "Macro '%s' redefined,\n", macroname);
       Swig_error(Getfile(m1), Getline(m1), "previous definition of '%s'.\n", macroname);
@@ -526,6 +594,7 @@ Hash *Preprocessor_define(const_String_or_char_ptr _str, int swigmacro) {
     }
   } else {
     Setattr(symbols, macroname, macro);
+    macro_filter_add(macroname);
     Delete(macro);
   }
 
@@ -554,6 +623,7 @@ void Preprocessor_undef(const_String_or_char_ptr str) {
   Hash *symbols;
   assert(cpp);
   symbols = Getattr(cpp, kpp_symbols);
+  macro_lookup(symbols, str);
   Delattr(symbols, str);
 }
 
@@ -742,7 +812,7 @@ static String *expand_macro(String *name, List *args, String *line_file) {
     return 0;
 
   /* See if the name is actually defined */
-  macro = Getattr(symbols, name);
+  macro = macro_lookup(symbols, name);
   if (!macro)
     return 0;
 
@@ -985,9 +1055,85 @@ static String *expand_macro(String *name, List *args, String *line_file) {
 
 /* #define SWIG_PUT_BUFF  */
 
+/* -----------------------------------------------------------------------------
+ * copy_plain_text()
+ *
+ * Fast path for Preprocessor_replace().  Starting at the current position in s,
+ * copies text that the state machine would pass through unchanged to ns in a
+ * single write: identifiers that can't be macros according to macro_filter,
+ * strings, comments and everything else up to the next identifier that might
+ * be a macro or the next '%' or '#'.  s is left positioned there, with its line
+ * number updated, in state 0 of the state machine.
+ * ----------------------------------------------------------------------------- */
+
+static void copy_plain_text(String *s, String *ns) {
+  char *base = Char(s);
+  char *end = base + Len(s);
+  char *start = base + Tell(s);
+  char *c = start;
+  char *nl;
+  int ch, line, lines;
+
+  while (c < end) {
+    ch = (unsigned char) *c;
+    if (isidentifier(ch)) {
+      char *e = c + 1;
+      while (e < end && isidchar((unsigned char) *e))
+	e++;
+      if (macro_filter_test(c, (int) (e - c)))
+	break;
+      c = e;
+    } else if (ch == '%' || ch == '#') {
+      break;
+    } else if (ch == '\"' || ch == '\'') {
+      /* Same as skip_tochar() */
+      c++;
+      while (c < end && *c != ch) {
+	if (*c == '\\' && c + 1 < end)
+	  c++;
+	c++;
+      }
+      if (c < end)
+	c++;
+    } else if (ch == '/' && c + 1 < end && c[1] == '/') {
+      nl = (char *) memchr(c + 2, '\n', (size_t) (end - c - 2));
+      if (nl) {
+	expand_defined_operator = 0;
+	c = nl + 1;
+      } else {
+	c = end;
+      }
+    } else if (ch == '/' && c + 1 < end && c[1] == '*') {
+      c += 2;
+      while (c + 1 < end && !(c[0] == '*' && c[1] == '/'))
+	c++;
+      c = (c + 1 < end) ? c + 2 : end;
+    } else if (ch == '\\') {
+      c++;
+      if (c < end && *c == '\n')
+	c++;
+    } else {
+      if (ch == '\n')
+	expand_defined_operator = 0;
+      c++;
+    }
+  }
+
+  if (c > start) {
+    line = Getline(s);
+    lines = 0;
+    for (nl = start; (nl = (char *) memchr(nl, '\n', (size_t) (c - nl))); nl++)
+      lines++;
+    Write(ns, start, (int) (c - start));
+    Seek(s, (long) (c - start), SEEK_CUR);
+    Setline(s, line + lines);
+  }
+}
+
 static DOH *Preprocessor_replace(DOH *s) {
   DOH *ns, *symbols, *m;
   int c, i, state = 0;
+  int fast;
   String *id = NewStringEmpty();
 
   assert(cpp);
@@ -997,8 +1143,17 @@ static DOH *Preprocessor_replace(DOH *s) {
   copy_location(s, ns);
   Seek(s, 0, SEEK_SET);
 
-  /* Try to locate identifiers in s and replace them with macro replacements */
-  while ((c = Getc(s)) != EOF) {
+  /* Try to locate identifiers in s and replace them with macro replacements.
+     The state machine only needs to see identifiers that might be macros and
+     the '%' and '#' directives, copy_plain_text() takes care of the rest.  When
+     Preprocessor_parse_cached() is recording every macro looked up, including
+     those that are not defined, all identifiers go through the state machine. */
+  fast = !macro_lookups && DohIsString(s);
+  for (;;) {
+    if (state == 0 && fast)
+      copy_plain_text(s, ns);
+    if ((c = Getc(s)) == EOF)
+      break;
     switch (state) {
     case 0:
       if (isidentifier(c)) {
@@ -1091,7 +1246,7 @@ static DOH *Preprocessor_replace(DOH *s) {
 	    }
 	    for (i = 0; i < lenargs; i++) {
 	      DOH *o = Getitem(args, i);
-	      if (!Getattr(symbols, o)) {
+	      if (!macro_lookup(symbols, o)) {
 		break;
 	      }
 	    }
@@ -1127,7 +1282,7 @@ static DOH *Preprocessor_replace(DOH *s) {
 	  Swig_warning(998, Getfile(s), Getline(s), "The %s preprocessor directive does not work in macros, try #if instead.\n", id);
 	  Append(ns, id);
 	  */
-	} else if ((m = Getattr(symbols, id))) {
+	} else if ((m = macro_lookup(symbols, id))) {
 	  /* See if the macro is defined in the preprocessor symbol table */
 	  DOH *args = 0;
 	  DOH *e;
@@ -1212,7 +1367,7 @@ static DOH *Preprocessor_replace(DOH *s) {
       Replaceall(fn, "\\", "\\\\");
       Printf(ns, "\"%s\"", fn);
       Delete(fn);
-    } else if (Getattr(symbols, id)) {
+    } else if (macro_lookup(symbols, id)) {
       DOH *e;
       /* Yes.  There is a macro here */
       /* See if the macro expects arguments */
@@ -1571,7 +1726,7 @@ String *Preprocessor_parse(String *s) {
 	  start_level = level;
 	  if (Len(value) > 0) {
 	    /* See if the identifier is in the hash table */
-	    if (!Getattr(symbols, value))
+	    if (!macro_lookup(symbols, value))
 	      allow = 0;
 	  } else {
 	    Swig_error(Getfile(s), Getline(id), "Missing identifier for #ifdef.\n");
@@ -1586,7 +1741,7 @@ String *Preprocessor_parse(String *s) {
 	  start_level = level;
 	  if (Len(value) > 0) {
 	    /* See if the identifier is in the hash table */
-	    if (Getattr(symbols, value))
+	    if (macro_lookup(symbols, value))
 	      allow = 0;
 	  } else {
 	    Swig_error(Getfile(s), Getline(id), "Missing identifier for #ifndef.\n");
@@ -1757,6 +1912,9 @@ String *Preprocessor_parse(String *s) {
 	      String *val = NewString(c + 7);
 	      String *nowarn = Preprocessor_replace(val);
 	      Swig_warnfilter(nowarn, 1);
+	      if (!nowarn_pragmas)
+		nowarn_pragmas = NewList();
+	      Append(nowarn_pragmas, nowarn);
 	      Delete(nowarn);
 	      Delete(val);
 	    } else if (strncmp(c, "cpperraswarn=", 13) == 0) {
@@ -2033,3 +2191,367 @@ String *Preprocessor_parse(String *s) {
 
   return ns;
 }
+
+/* -----------------------------------------------------------------------------
+ * Preprocessor cache
+ *
+ * Preprocessor_parse_cached() preprocesses a string in the same way as
+ * Preprocessor_parse(), but keeps the result in a cache file.  This is
+ * intended for the SWIG library files included at the start of every run
+ * (swig.swg and the language module's .swg file), which are the same for
+ * every interface file.  The cache file holds the preprocessed text along with
+ * the preprocessor state left behind: the macros defined or undefined, the
+ * files included and any #pragma SWIG nowarn seen.
+ *
+ * The cache file name is a hash of a key made from the text being
+ * preprocessed, the search path, the current directory, the preprocessor
+ * options and the warning filter.  The full key is also stored in the file and
+ * compared when loading.  The cache file is only used if every macro looked up
+ * while preprocessing still has the same definition (or is still undefined)
+ * and the size and modification time of every file read are unchanged.
+ * Otherwise the text is preprocessed again and the cache file replaced.
+ * Nothing is cached if any warnings or errors are issued.
+ * ----------------------------------------------------------------------------- */
+
+#define CACHE_MAGIC "SWIG preprocessor cache 2"
+
+/* A string describing a macro definition, "-" if not defined */
+static String *macro_describe(Hash *macro) {
+  String *d;
+  List *args;
+  if (!macro)
+    return NewString("-");
+  args = Getattr(macro, kpp_args);
+  d = NewStringf("=%s:%d:%d%s", Getfile(macro), Getline(macro), Getline(Getattr(macro, kpp_value)), Getattr(macro, kpp_swigmacro) ? " %define" : "");
+  if (args) {
+    int i;
+    Append(d, "(");
+    for (i = 0; i < Len(args); i++)
+      Printf(d, "%s%s", i ? "," : "", Getitem(args, i));
+    Printf(d, ")%s", Getattr(macro, kpp_varargs) ? "..." : "");
+  }
+  Printf(d, " %s", Getattr(macro, kpp_value));
+  return d;
+}
+
+static void cache_write_string(FILE *f, const char *tag, const_String_or_char_ptr s) {
+  const char *c = s ? Char(s) : "";
+  int len = s ? Len(s) : 0;
+  fprintf(f, "%s %d\n", tag, len);
+  fwrite(c, 1, (size_t) len, f);
+  fputc('\n', f);
+}
+
+static void cache_write_int(FILE *f, const char *tag, int value) {
+  String *s = NewStringf("%d", value);
+  cache_write_string(f, tag, s);
+  Delete(s);
+}
+
+/* Read the next record, its tag is returned in tag (at least 32 chars) */
+static String *cache_read_record(FILE *f, char *tag) {
+  char buf[64];
+  char *space;
+  int len;
+  char *data;
+  String *s;
+  if (!fgets(buf, sizeof(buf), f))
+    return 0;
+  space = strchr(buf, ' ');
+  if (!space || space - buf >= 32)
+    return 0;
+  len = atoi(space + 1);
+  if (len < 0)
+    return 0;
+  memcpy(tag, buf, (size_t) (space - buf));
+  tag[space - buf] = 0;
+  data = (char *) malloc((size_t) len + 1);
+  if (!data)
+    return 0;
+  if (fread(data, 1, (size_t) len, f) != (size_t) len || fgetc(f) != '\n') {
+    free(data);
+    return 0;
+  }
+  data[len] = 0;
+  s = NewStringWithSize(data, len);
+  free(data);
+  return s;
+}
+
+/* Size and modification time of a file, or an empty string if it can't be stat'ed */
+static String *cache_file_stamp(const_String_or_char_ptr filename) {
+  struct stat st;
+  if (stat(Char(filename), &st) != 0)
+    return NewStringEmpty();
+  return NewStringf("%ld %ld", (long) st.st_size, (long) st.st_mtime);
+}
+
+static String *cache_key(String *s) {
+  String *key = NewStringf("%s\nSWIG %s\n", CACHE_MAGIC, Swig_package_version());
+  List *path;
+  String *filter;
+  Iterator ki;
+  char cwd[4096];
+  int i;
+
+  Printf(key, "options %d %d %d %d %d %d\n", include_all, import_all, ignore_missing, single_include, error_as_warning, Swig_get_push_dir());
+  filter = Swig_warnfilter_get();
+  Printf(key, "warnings %s\n", filter);
+  Delete(filter);
+  Printf(key, "cwd %s\n", getcwd(cwd, sizeof(cwd)) ? cwd : "");
+  path = Swig_search_path();
+  for (i = 0; i < Len(path); i++)
+    Printf(key, "path %s\n", Getitem(path, i));
+  Delete(path);
+  for (ki = First(included_files); ki.key; ki = Next(ki))
+    Printf(key, "included %s\n", ki.key);
+  Printf(key, "text %s\n", s);
+  return key;
+}
+
+static unsigned long cache_hash(String *key) {
+  unsigned long h = 2166136261UL;
+  const unsigned char *c = (const unsigned char *) Char(key);
+  int len = Len(key);
+  int i;
+  for (i = 0; i < len; i++) {
+    h ^= c[i];
+    h = (h * 16777619UL) & 0xffffffffUL;
+  }
+  return h;
+}
+
+/* Write the preprocessed text and preprocessor state to the cache file */
+static void cache_save(String *filename, String *key, String *ns, int first_dependency, int first_nowarn) {
+  Hash *symbols = Getattr(cpp, kpp_symbols);
+  String *tmpname = NewStringf("%s.%ld", filename, (long) getpid());
+  FILE *f = fopen(Char(tmpname), "wb");
+  Iterator ki;
+  int i;
+
+  if (!f) {
+    Delete(tmpname);
+    return;
+  }
+  cache_write_string(f, "key", key);
+  for (i = first_dependency; i < Len(dependencies); i++) {
+    String *stamp = cache_file_stamp(Getitem(dependencies, i));
+    cache_write_string(f, "file", Getitem(dependencies, i));
+    cache_write_string(f, "stamp", stamp);
+    Delete(stamp);
+  }
+  for (ki = First(included_files); ki.key; ki = Next(ki)) {
+    cache_write_string(f, "included", ki.key);
+  }
+  for (i = first_nowarn; i < Len(nowarn_pragmas); i++) {
+    cache_write_string(f, "nowarn", Getitem(nowarn_pragmas, i));
+  }
+  cache_write_int(f, "cpperraswarn", error_as_warning);
+  for (ki = First(macro_lookups); ki.key; ki = Next(ki)) {
+    Hash *macro = Getattr(symbols, ki.key);
+    List *args;
+    String *value;
+    if (!macro) {
+      cache_write_string(f, "undef", ki.key);
+      cache_write_string(f, "before", ki.item);
+      continue;
+    }
+    args = Getattr(macro, kpp_args);
+    value = Getattr(macro, kpp_value);
+    cache_write_string(f, "macro", ki.key);
+    cache_write_string(f, "before", ki.item);
+    cache_write_string(f, "mfile", Getfile(macro));
+    cache_write_int(f, "mline", Getline(macro));
+    cache_write_int(f, "vline", Getline(value));
+    if (Getattr(macro, kpp_varargs))
+      cache_write_int(f, "varargs", 1);
+    if (Getattr(macro, kpp_swigmacro))
+      cache_write_int(f, "swigmacro", 1);
+    if (args) {
+      int j;
+      cache_write_int(f, "args", Len(args));
+      for (j = 0; j < Len(args); j++)
+	cache_write_string(f, "arg", Getitem(args, j));
+    }
+    cache_write_string(f, "value", value);
+  }
+  cache_write_string(f, "text", ns);
+  if (fclose(f) != 0) {
+    remove(Char(tmpname));
+  } else {
+    /* Replace any existing cache file in one step as other SWIG processes may be reading it */
+#ifdef _WIN32
+    remove(Char(filename));
+#endif
+    if (rename(Char(tmpname), Char(filename)) != 0)
+      remove(Char(tmpname));
+  }
+  Delete(tmpname);
+}
+
+/* Read a cache file written by cache_save().  If it is valid and up to date,
+   restore the preprocessor state and return the preprocessed text. */
+static String *cache_load(String *filename, String *key) {
+  FILE *f = fopen(Char(filename), "rb");
+  Hash *symbols = Getattr(cpp, kpp_symbols);
+  char tag[32];
+  String *r;
+  String *ns = 0;
+  String *file = 0;
+  Hash *macros;
+  Hash *macro = 0;
+  String *name = 0;
+  List *args = 0;
+  List *files;
+  List *included;
+  List *nowarn;
+  Iterator ki;
+  int cpperraswarn = 0;
+  int vline = 0;
+  int valid = 1;
+  int i;
+
+  if (!f)
+    return 0;
+  r = cache_read_record(f, tag);
+  if (!r || strcmp(tag, "key") != 0 || !Equal(r, key)) {
+    Delete(r);
+    fclose(f);
+    return 0;
+  }
+  Delete(r);
+
+  macros = NewHash();
+  files = NewList();
+  included = NewList();
+  nowarn = NewList();
+  while (valid && !ns && (r = cache_read_record(f, tag))) {
+    if (strcmp(tag, "file") == 0) {
+      Delete(file);
+      file = Copy(r);
+      Append(files, r);
+    } else if (strcmp(tag, "stamp") == 0) {
+      String *stamp = cache_file_stamp(file);
+      valid = file && Equal(stamp, r);
+      Delete(stamp);
+    } else if (strcmp(tag, "included") == 0) {
+      Append(included, r);
+    } else if (strcmp(tag, "nowarn") == 0) {
+      Append(nowarn, r);
+    } else if (strcmp(tag, "cpperraswarn") == 0) {
+      cpperraswarn = atoi(Char(r));
+    } else if (strcmp(tag, "undef") == 0) {
+      /* Macros are only looked up by name, so None marks one that is undefined */
+      Delete(name);
+      name = Copy(r);
+      Setattr(macros, name, DohNone);
+      macro = 0;
+    } else if (strcmp(tag, "macro") == 0) {
+      Delete(name);
+      name = Copy(r);
+      macro = NewHash();
+      args = 0;
+      Setattr(macro, kpp_name, name);
+      Setattr(macros, name, macro);
+      Delete(macro);
+    } else if (name && strcmp(tag, "before") == 0) {
+      String *d = macro_describe(Getattr(symbols, name));
+      valid = Equal(d, r);
+      Delete(d);
+    } else if (macro && strcmp(tag, "mfile") == 0) {
+      Setfile(macro, r);
+      Setfile(name, r);
+    } else if (macro && strcmp(tag, "mline") == 0) {
+      Setline(macro, atoi(Char(r)));
+      Setline(name, atoi(Char(r)));
+    } else if (macro && strcmp(tag, "vline") == 0) {
+      vline = atoi(Char(r));
+    } else if (macro && strcmp(tag, "varargs") == 0) {
+      Setattr(macro, kpp_varargs, "1");
+    } else if (macro && strcmp(tag, "swigmacro") == 0) {
+      Setattr(macro, kpp_swigmacro, "1");
+    } else if (macro && strcmp(tag, "args") == 0) {
+      args = NewList();
+      Setattr(macro, kpp_args, args);
+      Delete(args);
+    } else if (args && strcmp(tag, "arg") == 0) {
+      Append(args, r);
+    } else if (macro && strcmp(tag, "value") == 0) {
+      Setfile(r, Getfile(macro));
+      Setline(r, vline);
+      Setattr(macro, kpp_value, r);
+      macro = 0;
+      args = 0;
+    } else if (strcmp(tag, "text") == 0) {
+      ns = Copy(r);
+    } else {
+      valid = 0;
+    }
+    Delete(r);
+  }
+  fclose(f);
+  Delete(file);
+  Delete(name);
+
+  if (valid && ns) {
+    for (ki = First(macros); ki.key; ki = Next(ki)) {
+      if (ki.item == DohNone)
+	Delattr(symbols, ki.key);
+      else {
+	Setattr(symbols, ki.key, ki.item);
+	macro_filter_add(ki.key);
+      }
+    }
+    for (i = 0; i < Len(included); i++)
+      Setattr(included_files, Getitem(included, i), Getitem(included, i));
+    if (!dependencies)
+      dependencies = NewList();
+    for (i = 0; i < Len(files); i++)
+      Append(dependencies, Getitem(files, i));
+    if (!nowarn_pragmas)
+      nowarn_pragmas = NewList();
+    for (i = 0; i < Len(nowarn); i++) {
+      Swig_warnfilter(Getitem(nowarn, i), 1);
+      Append(nowarn_pragmas, Getitem(nowarn, i));
+    }
+    error_as_warning = cpperraswarn;
+  } else {
+    Delete(ns);
+    ns = 0;
+  }
+  Delete(macros);
+  Delete(files);
+  Delete(included);
+  Delete(nowarn);
+  return ns;
+}
+
+/* -----------------------------------------------------------------------------
+ * Preprocessor_parse_cached()
+ *
+ * Same as Preprocessor_parse(), but the result is looked up in and saved to
+ * a cache file in the cachedir directory.
+ * ----------------------------------------------------------------------------- */
+
+String *Preprocessor_parse_cached(String *s, const_String_or_char_ptr cachedir) {
+  String *key = cache_key(s);
+  String *filename = NewStringf("%s%sswig-%08lx.cache", cachedir, SWIG_FILE_DELIMITER, cache_hash(key));
+  String *ns = cache_load(filename, key);
+  if (!ns) {
+    int nwarnings = Swig_warn_count();
+    int nerrors = Swig_error_count();
+    int first_dependency = dependencies ? Len(dependencies) : 0;
+    int first_nowarn = nowarn_pragmas ? Len(nowarn_pragmas) : 0;
+    macro_lookups = NewHash();
+    ns = Preprocessor_parse(s);
+    if (Swig_warn_count() == nwarnings && Swig_error_count() == nerrors)
+      cache_save(filename, key, ns, first_dependency, first_nowarn);
+    Delete(macro_lookups);
+    macro_lookups = 0;
+  } else {
+    copy_location(s, ns);
+  }
+  Delete(filename);
+  Delete(key);
+  return ns;
+}
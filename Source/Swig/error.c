@@ -222,6 +222,16 @@ void Swig_warnall(void) {
 }
 
 
+/* -----------------------------------------------------------------------------
+ * Swig_warnfilter_get()
+ *
+ * Return a string describing which warnings are currently suppressed.
+ * ----------------------------------------------------------------------------- */
+
+String *Swig_warnfilter_get(void) {
+  return NewStringf("%s%s", warnall ? "all:" : "", filter ? filter : "");
+}
+
 /* ----------------------------------------------------------------------------- 
  * Swig_warn_count()
  *
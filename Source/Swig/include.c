@@ -14,12 +14,34 @@
  * ----------------------------------------------------------------------------- */
 
 #include "swig.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
 
 static List   *directories = 0;	        /* List of include directories */
 static String *lastpath = 0;	        /* Last file that was included */
 static List   *pdirectories = 0;        /* List of pushed directories  */
 static int     dopush = 1;		/* Whether to push directories */
 static int file_debug = 0;
+static List   *opened_files = 0;	/* Every file successfully opened */
+static Hash   *opened_seen = 0;
+static List   *missing_probed = 0;	/* Every file looked for but not found */
+static Hash   *file_contents = 0;	/* Contents of included files, keyed by path */
+static Hash   *resolved_files = 0;	/* Search path and name -> full pathname found */
+static Hash   *missing_files = 0;	/* Full pathnames known not to exist, whatever the search path */
+static int     search_path_version = 0;	/* Changes whenever the search path changes */
+
+/* Search path lists built by Swig_search_path_any(), one for normal and one for
+   system includes, along with a string identifying each for resolved_files */
+static List   *search_path_list[2] = {0, 0};
+static String *search_path_key[2] = {0, 0};
+static int     search_path_list_version[2] = {-1, -1};
+
+static int file_open_count = 0;
+static int file_resolve_hits = 0;
+static int file_probe_count = 0;
+static int file_probe_skipped = 0;
+static int file_contents_hits = 0;
 
 /* This functions determine whether to push/pop dirs in the preprocessor */
 void Swig_set_push_dir(int push) {
@@ -46,6 +68,7 @@ List *Swig_add_directory(const_String_or_char_ptr dirname) {
     Append(directories,adirname);
     Delete(adirname);
   }
+  search_path_version++;
   return directories;
 }
 
@@ -67,6 +90,7 @@ void Swig_push_directory(const_String_or_char_ptr dirname) {
   assert(pdirname);
   Insert(pdirectories,0,pdirname);
   Delete(pdirname);
+  search_path_version++;
 }
 
 /* -----------------------------------------------------------------------------
@@ -82,6 +106,7 @@ void Swig_pop_directory(void) {
   if (!pdirectories)
     return;
   Delitem(pdirectories, 0);
+  search_path_version++;
 }
 
 /* -----------------------------------------------------------------------------
@@ -95,6 +120,32 @@ String *Swig_last_file(void) {
   return lastpath;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_opened_files()
+ * 
+ * Returns the full pathnames of all the files opened so far, in the order they
+ * were first opened.
+ * ----------------------------------------------------------------------------- */
+
+List *Swig_opened_files(void) {
+  if (!opened_files)
+    opened_files = NewList();
+  return opened_files;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_missing_files()
+ * 
+ * Returns the full pathnames of all the files looked for so far that did not
+ * exist, in the order they were first looked for.
+ * ----------------------------------------------------------------------------- */
+
+List *Swig_missing_files(void) {
+  if (!missing_probed)
+    missing_probed = NewList();
+  return missing_probed;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_search_path_any() 
  * 
@@ -149,6 +200,60 @@ List *Swig_search_path() {
   return Swig_search_path_any(0);
 }
 
+/* -----------------------------------------------------------------------------
+ * search_path_cached()
+ *
+ * Returns the current search path, only building it again if a directory has
+ * been added, pushed or popped since it was last built.  The list is owned by
+ * this file.  *key is set to a string that is the same for any two identical
+ * search paths.
+ * ----------------------------------------------------------------------------- */
+
+static List *search_path_cached(int syspath, String **key) {
+  syspath = syspath ? 1 : 0;
+  if (search_path_list_version[syspath] != search_path_version) {
+    Iterator it;
+    Delete(search_path_list[syspath]);
+    Delete(search_path_key[syspath]);
+    search_path_list[syspath] = Swig_search_path_any(syspath);
+    search_path_key[syspath] = NewStringf("%d", syspath);
+    for (it = First(search_path_list[syspath]); it.item; it = Next(it)) {
+      Printf(search_path_key[syspath], "\n%s", it.item);
+    }
+    search_path_list_version[syspath] = search_path_version;
+  }
+  *key = search_path_key[syspath];
+  return search_path_list[syspath];
+}
+
+/* -----------------------------------------------------------------------------
+ * probe_file()
+ *
+ * fopen() a candidate file, remembering the names that do not exist so that
+ * they are not tried again.  With many include directories, most of the
+ * candidates tried for each %include or %import do not exist.  Other failures,
+ * such as running out of file descriptors, are not remembered.
+ * ----------------------------------------------------------------------------- */
+
+static FILE *probe_file(String *filename) {
+  FILE *f;
+  if (missing_files && Getattr(missing_files, filename)) {
+    file_probe_skipped++;
+    return 0;
+  }
+  file_probe_count++;
+  f = fopen(Char(filename), "r");
+  if (!f && errno == ENOENT) {
+    String *missing = Copy(filename);
+    if (!missing_files)
+      missing_files = NewHash();
+    Setattr(missing_files, missing, "1");
+    Append(Swig_missing_files(), missing);
+    Delete(missing);
+  }
+  return f;
+}
+
 
 
 /* -----------------------------------------------------------------------------
@@ -162,6 +267,9 @@ static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_
   FILE *f;
   String *filename;
   List *spath = 0;
+  String *spath_key = 0;
+  String *resolve_key = 0;
+  String *resolved;
   char *cname;
   int i, ilen, nbytes;
   char bom[3];
@@ -176,22 +284,50 @@ static FILE *Swig_open_file(const_String_or_char_ptr name, int sysfile, int use_
   if (file_debug) {
     Printf(stdout, "  Open: %s\n", filename);
   }
-  f = fopen(Char(filename), "r");
+  file_open_count++;
+  f = probe_file(filename);
   if (!f && use_include_path) {
-    spath = Swig_search_path_any(sysfile);
-    ilen = Len(spath);
-    for (i = 0; i < ilen; i++) {
+    spath = search_path_cached(sysfile, &spath_key);
+    resolve_key = NewStringf("%s\n%s", spath_key, cname);
+    resolved = resolved_files ? Getattr(resolved_files, resolve_key) : 0;
+    if (resolved) {
       Clear(filename);
-      Printf(filename, "%s%s", Getitem(spath, i), cname);
+      Append(filename, resolved);
       f = fopen(Char(filename), "r");
-      if (f)
-	break;
+      if (f) {
+	file_resolve_hits++;
+	if (file_debug) {
+	  Printf(stdout, "  Resolved: %s (cached)\n", filename);
+	}
+      }
     }
-    Delete(spath);
+    if (!f) {
+      ilen = Len(spath);
+      for (i = 0; i < ilen; i++) {
+	Clear(filename);
+	Printf(filename, "%s%s", Getitem(spath, i), cname);
+	f = probe_file(filename);
+	if (f) {
+	  if (!resolved_files)
+	    resolved_files = NewHash();
+	  Setattr(resolved_files, resolve_key, filename);
+	  break;
+	}
+      }
+    }
+    Delete(resolve_key);
   }
   if (f) {
     Delete(lastpath);
     lastpath = filename;
+    if (!opened_seen)
+      opened_seen = NewHash();
+    if (!Getattr(opened_seen, filename)) {
+      String *opened = Copy(filename);
+      Setattr(opened_seen, opened, "1");
+      Append(Swig_opened_files(), opened);
+      Delete(opened);
+    }
 
     /* Skip the UTF-8 BOM if it's present */
     nbytes = fread(bom, 1, 3, f);
@@ -224,13 +360,39 @@ FILE *Swig_open(const_String_or_char_ptr name) {
 
 String *Swig_read_file(FILE *f) {
   int len;
-  char buffer[4096];
-  String *str = NewStringEmpty();
+  String *str;
+  long pos, end;
+  size_t size = 0;
+  size_t nbytes;
+  size_t total = 0;
+  char *buffer;
+
+  /* Presize the buffer from the remaining length of the file, so it is
+     normally read with a single fread() */
+  pos = ftell(f);
+  if (pos >= 0 && fseek(f, 0, SEEK_END) == 0) {
+    end = ftell(f);
+    if (end > pos)
+      size = (size_t) (end - pos);
+    fseek(f, pos, SEEK_SET);
+  }
+  if (size < 4096)
+    size = 4096;
+  buffer = (char *) malloc(size + 1);
+  assert(buffer);
+  while ((nbytes = fread(buffer + total, 1, size - total, f)) > 0) {
+    total += nbytes;
+    if (total == size) {
+      size *= 2;
+      buffer = (char *) realloc(buffer, size + 1);
+      assert(buffer);
+    }
+  }
+  buffer[total] = 0;
+  str = NewStringWithSize(buffer, (int) total);
+  free(buffer);
 
   assert(str);
-  while (fgets(buffer, 4095, f)) {
-    Append(str, buffer);
-  }
   len = Len(str);
   /* Add a newline if not present on last line -- the preprocessor seems to 
    * rely on \n and not EOF terminating lines */
@@ -253,14 +415,44 @@ static String *Swig_include_any(const_String_or_char_ptr name, int sysfile) {
   FILE *f;
   String *str;
   String *file;
+  String *stamp;
+  Hash *cached;
+  struct stat st;
 
   f = Swig_open_file(name, sysfile, 1);
   if (!f)
     return 0;
-  str = Swig_read_file(f);
+  file = Copy(Swig_last_file());
+
+  /* The same header is often %included or %imported by many modules in one
+     run, so the contents are kept and only re-read if the file has changed */
+  if (stat(Char(file), &st) == 0)
+    stamp = NewStringf("%ld %ld", (long) st.st_size, (long) st.st_mtime);
+  else
+    stamp = 0;
+  cached = file_contents ? Getattr(file_contents, file) : 0;
+  if (cached && stamp && Equal(Getattr(cached, "stamp"), stamp)) {
+    file_contents_hits++;
+    str = Copy(Getattr(cached, "contents"));
+  } else {
+    str = Swig_read_file(f);
+    if (stamp) {
+      String *contents = str;
+      if (!file_contents)
+	file_contents = NewHash();
+      cached = NewHash();
+      Setattr(cached, "stamp", stamp);
+      Setattr(cached, "contents", contents);
+      Setattr(file_contents, file, cached);
+      Delete(cached);
+      /* The caller may modify the string it gets, so the cached one is never handed out */
+      str = Copy(contents);
+      Delete(contents);
+    }
+  }
   fclose(f);
+  Delete(stamp);
   Seek(str, 0, SEEK_SET);
-  file = Copy(Swig_last_file());
   Setfile(str, file);
   Delete(file);
   Setline(str, 1);
@@ -378,3 +570,20 @@ String *Swig_file_dirname(const_String_or_char_ptr filename) {
 void Swig_file_debug_set() {
   file_debug = 1;
 }
+
+/* -----------------------------------------------------------------------------
+ * Swig_file_debug_statistics()
+ *
+ * Display how effective the include path resolution and file contents caches
+ * were
+ * ----------------------------------------------------------------------------- */
+
+void Swig_file_debug_statistics(void) {
+  Printf(stdout, "---[ file resolution cache ]-------------------------------------------------\n");
+  Printf(stdout, "Files opened        : %d\n", file_open_count);
+  Printf(stdout, "Resolved from cache : %d\n", file_resolve_hits);
+  Printf(stdout, "Paths probed        : %d\n", file_probe_count);
+  Printf(stdout, "Probes skipped      : %d (known missing)\n", file_probe_skipped);
+  Printf(stdout, "Contents from cache : %d\n", file_contents_hits);
+  Printf(stdout, "-----------------------------------------------------------------------------\n");
+}
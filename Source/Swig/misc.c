@@ -18,11 +18,16 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <time.h>
+
 #ifdef _WIN32
 #include <direct.h>
 #ifndef S_ISDIR
 #define S_ISDIR(mode) (((mode) & S_IFDIR) == S_IFDIR)
 #endif
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
 #endif
 
 static char *fake_version = 0;
@@ -1113,6 +1118,97 @@ String *Swig_string_strip(String *s) {
 #include <pcre.h>
 #endif
 
+/* A compiled regular expression in the regex cache */
+typedef struct {
+  pcre *compiled;
+  pcre_extra *extra;		/* pcre_study() data, including JIT code */
+  char *prefix;			/* Literal text any match must start with */
+  int prefixlen;
+} RegexCacheEntry;
+
+static Hash *regex_cache = 0;
+
+static void regex_cache_entry_delete(void *ptr) {
+  RegexCacheEntry *entry = (RegexCacheEntry *) ptr;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  pcre_free_study(entry->extra);
+#else
+  pcre_free(entry->extra);
+#endif
+  pcre_free(entry->compiled);
+  free(entry->prefix);
+  free(entry);
+}
+
+/* -----------------------------------------------------------------------------
+ * regex_literal_prefix()
+ *
+ * Returns the length of the literal text that a pattern anchored with '^'
+ * requires at the start of the subject, or 0 if there is none (or the pattern
+ * is too complicated to tell).
+ * ----------------------------------------------------------------------------- */
+
+static int regex_literal_prefix(const char *pattern) {
+  const char *c;
+  int len = 0;
+  if (*pattern != '^' || strchr(pattern, '|'))
+    return 0;
+  for (c = pattern + 1; *c && !strchr("\\^$.[]()?*+{}", *c); c++)
+    len++;
+  if (len && *c && strchr("?*{", *c))
+    len--;			/* Last character is optional or repeated */
+  return len;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_regex_exec()
+ *
+ * Matches input against a regular expression.  The same few %rename and
+ * %namewarn patterns are matched against every declaration, so each pattern
+ * is compiled (and JIT compiled, if the PCRE library supports it) only once.
+ * Input that cannot match an anchored pattern's literal prefix is rejected
+ * without running the regex.
+ *
+ * Returns the pcre_exec() result.  If the pattern does not compile, *errmsg
+ * and *errpos are set and PCRE_ERROR_NOMATCH is returned.
+ * ----------------------------------------------------------------------------- */
+
+int Swig_regex_exec(String *pattern, const char *input, int len, int *captures, int ncaptures, const char **errmsg, int *errpos) {
+  RegexCacheEntry *entry;
+  DOH *v;
+
+  *errmsg = 0;
+  if (!regex_cache)
+    regex_cache = NewHash();
+  v = Getattr(regex_cache, pattern);
+  if (v) {
+    entry = (RegexCacheEntry *) Data(v);
+  } else {
+    const char *studyerr = 0;
+    pcre *compiled = pcre_compile(Char(pattern), 0, errmsg, errpos, NULL);
+    if (!compiled)
+      return PCRE_ERROR_NOMATCH;
+    entry = (RegexCacheEntry *) malloc(sizeof(RegexCacheEntry));
+    entry->compiled = compiled;
+#ifdef PCRE_STUDY_JIT_COMPILE
+    entry->extra = pcre_study(compiled, PCRE_STUDY_JIT_COMPILE, &studyerr);
+#else
+    entry->extra = pcre_study(compiled, 0, &studyerr);
+#endif
+    entry->prefixlen = regex_literal_prefix(Char(pattern));
+    entry->prefix = (char *) malloc(entry->prefixlen + 1);
+    memcpy(entry->prefix, Char(pattern) + 1, entry->prefixlen);
+    entry->prefix[entry->prefixlen] = 0;
+    v = NewVoid(entry, regex_cache_entry_delete);
+    Setattr(regex_cache, pattern, v);
+    Delete(v);
+  }
+
+  if (entry->prefixlen && ((len < entry->prefixlen) || (strncmp(input, entry->prefix, entry->prefixlen) != 0)))
+    return PCRE_ERROR_NOMATCH;
+  return pcre_exec(entry->compiled, entry->extra, input, len, 0, 0, captures, ncaptures);
+}
+
 static int split_regex_pattern_subst(String *s, String **pattern, String **subst, const char **input)
 {
   const char *pats, *pate;
@@ -1185,10 +1281,7 @@ String *replace_captures(int num_captures, const char *input, String *subst, int
  *   Printf(stderr,"gsl%(regex:/GSL_.*_/\\1/)s","GSL_Hello_") -> gslHello
  * ----------------------------------------------------------------------------- */
 String *Swig_string_regex(String *s) {
-  const int pcre_options = 0;
-
   String *res = 0;
-  pcre *compiled_pat = 0;
   const char *pcre_error, *input;
   int pcre_errorpos;
   String *pattern = 0, *subst = 0;
@@ -1197,14 +1290,12 @@ String *Swig_string_regex(String *s) {
   if (split_regex_pattern_subst(s, &pattern, &subst, &input)) {
     int rc;
 
-    compiled_pat = pcre_compile(
-          Char(pattern), pcre_options, &pcre_error, &pcre_errorpos, NULL);
-    if (!compiled_pat) {
+    rc = Swig_regex_exec(pattern, input, (int) strlen(input), captures, 30, &pcre_error, &pcre_errorpos);
+    if (pcre_error) {
       Swig_error("SWIG", Getline(s), "PCRE compilation failed: '%s' in '%s':%i.\n",
           pcre_error, Char(pattern), pcre_errorpos);
       exit(1);
     }
-    rc = pcre_exec(compiled_pat, NULL, input, strlen(input), 0, 0, captures, 30);
     if (rc >= 0) {
       res = replace_captures(rc, input, subst, captures, pattern, s);
     } else if (rc != PCRE_ERROR_NOMATCH) {
@@ -1216,7 +1307,6 @@ String *Swig_string_regex(String *s) {
 
   DohDelete(pattern);
   DohDelete(subst);
-  pcre_free(compiled_pat);
   return res ? res : NewStringEmpty();
 }
 
@@ -1237,6 +1327,222 @@ String *Swig_pcre_version(void) {
 
 #endif
 
+/* -----------------------------------------------------------------------------
+ * Timing
+ *
+ * Support for the -timing option.  Swig_timing_phase() ends the current phase
+ * and starts a new one.  For each phase the wall clock time, CPU time, number
+ * of DOH objects and bytes allocated and the peak resident set size at the end
+ * of the phase are recorded.  Swig_timing_start()/Swig_timing_stop() add up the
+ * time spent in an activity, such as typemap lookups, across the whole run.
+ * Nested (recursive) starts of the same activity are only timed once.  All of
+ * these do nothing unless Swig_timing_enable() has been called.
+ * ----------------------------------------------------------------------------- */
+
+#define TIMING_MAX 32
+
+typedef struct {
+  const char *name;
+  double wall;
+  double cpu;
+  unsigned long objects;
+  unsigned long bytes;
+  long peakrss;			/* Kilobytes, 0 if unknown */
+  unsigned long calls;		/* Activities only */
+  int depth;			/* Activities only */
+  double wallstart;
+  double cpustart;
+} Timing;
+
+static int timing_enabled = 0;
+static Timing timing_phases[TIMING_MAX];
+static int timing_nphases = 0;
+static Timing timing_activities[TIMING_MAX];
+static int timing_nactivities = 0;
+
+static double timing_wall(void) {
+#ifdef _WIN32
+  return (double) clock() / CLOCKS_PER_SEC;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double) tv.tv_sec + (double) tv.tv_usec / 1000000.0;
+#endif
+}
+
+static double timing_cpu(void) {
+  return (double) clock() / CLOCKS_PER_SEC;
+}
+
+static long timing_peakrss(void) {
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+    return 0;
+#ifdef __APPLE__
+  return (long) (ru.ru_maxrss / 1024);	/* bytes on Mac OS X */
+#else
+  return (long) ru.ru_maxrss;
+#endif
+#endif
+}
+
+/* Finish the phase in progress, if any */
+static void timing_phase_end(void) {
+  Timing *t;
+  unsigned long objects, bytes;
+  if (timing_nphases == 0)
+    return;
+  t = &timing_phases[timing_nphases - 1];
+  if (t->depth == 0)
+    return;
+  DohMemoryStatistics(&objects, &bytes);
+  t->wall = timing_wall() - t->wallstart;
+  t->cpu = timing_cpu() - t->cpustart;
+  t->objects = objects - t->objects;
+  t->bytes = bytes - t->bytes;
+  t->peakrss = timing_peakrss();
+  t->depth = 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_timing_enable()
+ * ----------------------------------------------------------------------------- */
+
+void Swig_timing_enable(void) {
+  timing_enabled = 1;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_timing_phase()
+ *
+ * End the current phase and start a new one called name.  A null name just
+ * ends the current phase.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_timing_phase(const char *name) {
+  Timing *t;
+  if (!timing_enabled)
+    return;
+  timing_phase_end();
+  if (!name || timing_nphases == TIMING_MAX)
+    return;
+  t = &timing_phases[timing_nphases++];
+  memset(t, 0, sizeof(Timing));
+  t->name = name;
+  t->depth = 1;
+  DohMemoryStatistics(&t->objects, &t->bytes);
+  t->wallstart = timing_wall();
+  t->cpustart = timing_cpu();
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_timing_start()
+ * Swig_timing_stop()
+ *
+ * Start and stop timing the named activity.
+ * ----------------------------------------------------------------------------- */
+
+static Timing *timing_activity(const char *name) {
+  int i;
+  Timing *t;
+  for (i = 0; i < timing_nactivities; i++) {
+    if (timing_activities[i].name == name || strcmp(timing_activities[i].name, name) == 0)
+      return &timing_activities[i];
+  }
+  if (timing_nactivities == TIMING_MAX)
+    return 0;
+  t = &timing_activities[timing_nactivities++];
+  memset(t, 0, sizeof(Timing));
+  t->name = name;
+  return t;
+}
+
+void Swig_timing_start(const char *name) {
+  Timing *t;
+  if (!timing_enabled)
+    return;
+  t = timing_activity(name);
+  if (t && t->depth++ == 0) {
+    t->calls++;
+    t->wallstart = timing_wall();
+    t->cpustart = timing_cpu();
+  }
+}
+
+void Swig_timing_stop(const char *name) {
+  Timing *t;
+  if (!timing_enabled)
+    return;
+  t = timing_activity(name);
+  if (t && t->depth > 0 && --t->depth == 0) {
+    t->wall += timing_wall() - t->wallstart;
+    t->cpu += timing_cpu() - t->cpustart;
+  }
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_timing_report()
+ *
+ * Display the timings gathered so far, as a table or, if json is set, as a
+ * JSON object.
+ * ----------------------------------------------------------------------------- */
+
+void Swig_timing_report(FILE *f, int json) {
+  int i;
+  double wall = 0.0, cpu = 0.0;
+  unsigned long objects = 0, bytes = 0;
+  long peakrss = 0;
+
+  if (!timing_enabled)
+    return;
+  timing_phase_end();
+  for (i = 0; i < timing_nphases; i++) {
+    wall += timing_phases[i].wall;
+    cpu += timing_phases[i].cpu;
+    objects += timing_phases[i].objects;
+    bytes += timing_phases[i].bytes;
+    if (timing_phases[i].peakrss > peakrss)
+      peakrss = timing_phases[i].peakrss;
+  }
+
+  if (json) {
+    fprintf(f, "{\n  \"phases\": [\n");
+    for (i = 0; i < timing_nphases; i++) {
+      Timing *t = &timing_phases[i];
+      fprintf(f, "    { \"name\": \"%s\", \"wall\": %.6f, \"cpu\": %.6f, \"objects\": %lu, \"bytes\": %lu, \"peak_rss_kb\": %ld }%s\n",
+	     t->name, t->wall, t->cpu, t->objects, t->bytes, t->peakrss, i + 1 < timing_nphases ? "," : "");
+    }
+    fprintf(f, "  ],\n  \"activities\": [\n");
+    for (i = 0; i < timing_nactivities; i++) {
+      Timing *t = &timing_activities[i];
+      fprintf(f, "    { \"name\": \"%s\", \"calls\": %lu, \"wall\": %.6f, \"cpu\": %.6f }%s\n",
+	     t->name, t->calls, t->wall, t->cpu, i + 1 < timing_nactivities ? "," : "");
+    }
+    fprintf(f, "  ],\n  \"total\": { \"wall\": %.6f, \"cpu\": %.6f, \"objects\": %lu, \"bytes\": %lu, \"peak_rss_kb\": %ld }\n}\n",
+	   wall, cpu, objects, bytes, peakrss);
+    return;
+  }
+
+  fprintf(f, "---[ timing ]---------------------------------------------------------------\n");
+  fprintf(f, "%-22s %10s %10s %12s %14s %12s\n", "phase", "wall (s)", "cpu (s)", "objects", "bytes", "peak rss (kB)");
+  for (i = 0; i < timing_nphases; i++) {
+    Timing *t = &timing_phases[i];
+    fprintf(f, "%-22s %10.3f %10.3f %12lu %14lu %12ld\n", t->name, t->wall, t->cpu, t->objects, t->bytes, t->peakrss);
+  }
+  fprintf(f, "%-22s %10.3f %10.3f %12lu %14lu %12ld\n", "total", wall, cpu, objects, bytes, peakrss);
+  if (timing_nactivities > 0) {
+    fprintf(f, "\n%-22s %10s %10s %12s\n", "activity", "wall (s)", "cpu (s)", "calls");
+    for (i = 0; i < timing_nactivities; i++) {
+      Timing *t = &timing_activities[i];
+      fprintf(f, "%-22s %10.3f %10.3f %12lu\n", t->name, t->wall, t->cpu, t->calls);
+    }
+  }
+  fprintf(f, "----------------------------------------------------------------------------\n");
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_init()
  *
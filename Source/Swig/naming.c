@@ -1190,22 +1190,18 @@ static DOH *Swig_get_lattr(Node *n, List *lattr) {
 #include <pcre.h>
 
 int Swig_name_regexmatch_value(Node *n, String *pattern, String *s) {
-  pcre *compiled_pat;
   const char *err;
   int errpos;
   int rc;
 
-  compiled_pat = pcre_compile(Char(pattern), 0, &err, &errpos, NULL);
-  if (!compiled_pat) {
+  rc = Swig_regex_exec(pattern, Char(s), Len(s), NULL, 0, &err, &errpos);
+  if (err) {
     Swig_error("SWIG", Getline(n),
                "Invalid regex \"%s\": compilation failed at %d: %s\n",
                Char(pattern), errpos, err);
     exit(1);
   }
 
-  rc = pcre_exec(compiled_pat, NULL, Char(s), Len(s), 0, 0, NULL, 0);
-  pcre_free(compiled_pat);
-
   if (rc == PCRE_ERROR_NOMATCH)
     return 0;
 
@@ -1292,6 +1288,47 @@ int Swig_name_match_nameobj(Hash *rn, Node *n) {
   return match;
 }
 
+/* -----------------------------------------------------------------------------
+ * nameobj_list_index()
+ *
+ * Most filters in the rename and namewarn lists have a plain target name that
+ * the name looked up must be equal to.  The index holds those "targets" and, in
+ * list order, the "others" without a plain target name.  A name that is not one
+ * of the targets can only match one of the others.  The index is rebuilt
+ * whenever the list has grown.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *namewarn_index = 0;
+static Hash *rename_index = 0;
+
+static Hash *nameobj_list_index(List *namelist) {
+  Hash **index = (namelist == namewarn_list) ? &namewarn_index : (namelist == rename_list) ? &rename_index : 0;
+  if (!index)
+    return 0;
+  if (!*index || GetInt(*index, "count") != Len(namelist)) {
+    Hash *targets = NewHash();
+    List *others = NewList();
+    Iterator ni;
+    for (ni = First(namelist); ni.item; ni = Next(ni)) {
+      Hash *rn = ni.item;
+      String *tname = Getattr(rn, "targetname");
+      if (tname && !Getattr(rn, "sourcefmt") && !GetFlag(rn, "regextarget") && !GetFlag(rn, "fullname")) {
+	Setattr(targets, tname, rn);
+      } else {
+	Append(others, rn);
+      }
+    }
+    Delete(*index);
+    *index = NewHash();
+    SetInt(*index, "count", Len(namelist));
+    Setattr(*index, "targets", targets);
+    Setattr(*index, "others", others);
+    Delete(others);
+    Delete(targets);
+  }
+  return *index;
+}
+
 /* -----------------------------------------------------------------------------
  * Hash *Swig_name_nameobj_lget()
  *
@@ -1302,9 +1339,15 @@ int Swig_name_match_nameobj(Hash *rn, Node *n) {
 Hash *Swig_name_nameobj_lget(List *namelist, Node *n, String *prefix, String *name, String *decl) {
   Hash *res = 0;
   if (namelist) {
-    int len = Len(namelist);
+    int len;
     int i;
     int match = 0;
+#if !defined(SWIG_USE_SIMPLE_MATCHOR)
+    Hash *index = nameobj_list_index(namelist);
+    if (index && !Getattr(Getattr(index, "targets"), name))
+      namelist = Getattr(index, "others");
+#endif
+    len = Len(namelist);
     for (i = 0; !match && (i < len); i++) {
       Hash *rn = Getitem(namelist, i);
       String *rdecl = Getattr(rn, "decl");
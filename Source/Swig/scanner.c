@@ -26,6 +26,13 @@ struct Scanner {
   String *text;			/* Current token value */
   List   *scanobjs;		/* Objects being scanned */
   String *str;			/* Current object being scanned */
+  char   *buf;			/* Data of str, read directly rather than with Getc() */
+  int     pos;			/* Current position in buf */
+  int     len;			/* Length of buf */
+  int     str_line;		/* Line number of str at pos, as Getline(str) would report it */
+  char   *tbuf;			/* Text of the token being scanned, copied to text once complete */
+  int     tlen;			/* Length of tbuf */
+  int     tmax;			/* Allocated size of tbuf */
   char   *idstart;		/* Optional identifier start characters */
   int     nexttoken;		/* Next token to be returned */
   int     start_line;		/* Starting line of certain declarations */
@@ -62,6 +69,13 @@ Scanner *NewScanner(void) {
   s->scanobjs = NewList();
   s->text = NewStringEmpty();
   s->str = 0;
+  s->buf = 0;
+  s->pos = 0;
+  s->len = 0;
+  s->str_line = 1;
+  s->tmax = 256;
+  s->tbuf = (char *) malloc(s->tmax);
+  s->tlen = 0;
   s->error = 0;
   s->error_line = 0;
   s->freeze_line = 0;
@@ -82,9 +96,77 @@ void DelScanner(Scanner * s) {
   Delete(s->error);
   Delete(s->str);
   free(s->idstart);
+  free(s->tbuf);
   free(s);
 }
 
+/* -----------------------------------------------------------------------------
+ * scanner_load()
+ * scanner_save()
+ *
+ * The scanner reads the string being scanned through a pointer to its data and
+ * keeps its own position and line number.  scanner_load() picks these up from
+ * the string, scanner_save() stores them back into it, so that they are right
+ * whenever the string is handed back to other code or scanned again later.
+ * ----------------------------------------------------------------------------- */
+
+static void scanner_load(Scanner *s) {
+  s->buf = Char(s->str);
+  s->len = Len(s->str);
+  s->pos = (int) Tell(s->str);
+  s->str_line = Getline(s->str);
+}
+
+static void scanner_save(Scanner *s) {
+  if (!s->str)
+    return;
+  (void)Seek(s->str, s->pos, SEEK_SET);
+  Setline(s->str, s->str_line);
+}
+
+/* -----------------------------------------------------------------------------
+ * text_putc()
+ * text_append()
+ * text_chop()
+ * text_flush()
+ *
+ * Build up the text of the current token in tbuf.  text_flush() copies the
+ * completed token into the text string returned by Scanner_text(), adding the
+ * newlines in it to the line number of the text string.
+ * ----------------------------------------------------------------------------- */
+
+static void text_putc(Scanner *s, char c) {
+  if (s->tlen >= s->tmax) {
+    s->tmax *= 2;
+    s->tbuf = (char *) realloc(s->tbuf, s->tmax);
+    assert(s->tbuf);
+  }
+  s->tbuf[s->tlen++] = c;
+}
+
+static void text_append(Scanner *s, const char *str) {
+  while (*str)
+    text_putc(s, *str++);
+}
+
+static void text_chop(Scanner *s) {
+  if (s->tlen > 0)
+    s->tlen--;
+}
+
+static void text_flush(Scanner *s) {
+  int line = Getline(s->text);
+  char *c = s->tbuf;
+  char *end = s->tbuf + s->tlen;
+  Clear(s->text);
+  Write(s->text, s->tbuf, s->tlen);
+  while ((c = (char *) memchr(c, '\n', (size_t) (end - c)))) {
+    line++;
+    c++;
+  }
+  Setline(s->text, line);
+}
+
 /* -----------------------------------------------------------------------------
  * Scanner_clear()
  *
@@ -93,8 +175,14 @@ void DelScanner(Scanner * s) {
 
 void Scanner_clear(Scanner * s) {
   assert(s);
+  scanner_save(s);
   Delete(s->str);
   Clear(s->text);
+  s->buf = 0;
+  s->pos = 0;
+  s->len = 0;
+  s->str_line = 1;
+  s->tlen = 0;
   Clear(s->scanobjs);
   Delete(s->error);
   s->str = 0;
@@ -122,11 +210,13 @@ void Scanner_push(Scanner * s, String *txt) {
   assert(s && txt);
   Push(s->scanobjs, txt);
   if (s->str) {
+    scanner_save(s);
     Setline(s->str,s->line);
     Delete(s->str);
   }
   s->str = txt;
   DohIncref(s->str);
+  scanner_load(s);
   s->line = Getline(txt);
 }
 
@@ -154,6 +244,7 @@ void Scanner_pushtoken(Scanner * s, int nt, const_String_or_char_ptr val) {
  * ----------------------------------------------------------------------------- */
 
 void Scanner_set_location(Scanner * s, String *file, int line) {
+  s->str_line = line;
   Setline(s->str, line);
   Setfile(s->str, file);
   s->line = line;
@@ -207,19 +298,25 @@ static char nextchar(Scanner * s) {
   int nc;
   if (!s->str)
     return 0;
-  while ((nc = Getc(s->str)) == EOF) {
+  while (s->pos >= s->len) {
+    scanner_save(s);
     Delete(s->str);
     s->str = 0;
     Delitem(s->scanobjs, 0);
     if (Len(s->scanobjs) == 0)
       return 0;
     s->str = Getitem(s->scanobjs, 0);
+    scanner_load(s);
     s->line = Getline(s->str);
     DohIncref(s->str);
   }
-  if ((nc == '\n') && (!s->freeze_line)) 
-    s->line++;
-  Putc(nc,s->text);
+  nc = (unsigned char) s->buf[s->pos++];
+  if (nc == '\n') {
+    s->str_line++;
+    if (!s->freeze_line)
+      s->line++;
+  }
+  text_putc(s, (char)nc);
   return (char)nc;
 }
 
@@ -269,15 +366,19 @@ static void retract(Scanner * s, int n) {
   int i, l;
   char *str;
 
-  str = Char(s->text);
-  l = Len(s->text);
+  str = s->tbuf;
+  l = s->tlen;
   assert(n <= l);
   for (i = 0; i < n; i++) {
     if (str[l - 1] == '\n') {
       if (!s->freeze_line) s->line--;
     }
-    (void)Seek(s->str, -1, SEEK_CUR);
-    Delitem(s->text, DOH_END);
+    if (s->pos > 0) {
+      s->pos--;
+      if (s->buf[s->pos] == '\n')
+	s->str_line--;
+    }
+    text_chop(s);
   }
 }
 
@@ -299,101 +400,101 @@ static void get_escape(Scanner *s) {
     switch (state) {
     case 0:
       if (c == 'n') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\n");
+	text_chop(s);
+	text_append(s, "\n");
 	return;
       }
       if (c == 'r') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\r");
+	text_chop(s);
+	text_append(s, "\r");
 	return;
       }
       if (c == 't') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\t");
+	text_chop(s);
+	text_append(s, "\t");
 	return;
       }
       if (c == 'a') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\a");
+	text_chop(s);
+	text_append(s, "\a");
 	return;
       }
       if (c == 'b') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\b");
+	text_chop(s);
+	text_append(s, "\b");
 	return;
       }
       if (c == 'f') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\f");
+	text_chop(s);
+	text_append(s, "\f");
 	return;
       }
       if (c == '\\') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\\");
+	text_chop(s);
+	text_append(s, "\\");
 	return;
       }
       if (c == 'v') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\v");
+	text_chop(s);
+	text_append(s, "\v");
 	return;
       }
       if (c == 'e') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\033");
+	text_chop(s);
+	text_append(s, "\033");
 	return;
       }
       if (c == '\'') {
-	Delitem(s->text, DOH_END);
-	Append(s->text,"\'");
+	text_chop(s);
+	text_append(s, "\'");
 	return;
       }
       if (c == '\"') {
-	Delitem(s->text, DOH_END);	
-	Append(s->text,"\"");
+	text_chop(s);	
+	text_append(s, "\"");
 	return;
       }
       if (c == '\n') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return;
       }
       if (isdigit(c)) {
 	state = 10;
 	result = (c - '0');
-	Delitem(s->text, DOH_END);
+	text_chop(s);
       } else if (c == 'x') {
 	state = 20;
-	Delitem(s->text, DOH_END);
+	text_chop(s);
       } else {
 	char tmp[3];
 	tmp[0] = '\\';
 	tmp[1] = (char)c;
 	tmp[2] = 0;
-	Delitem(s->text, DOH_END);
-	Append(s->text, tmp);
+	text_chop(s);
+	text_append(s, tmp);
 	return;
       }
       break;
     case 10:
       if (!isdigit(c)) {
 	retract(s,1);
-	Putc((char)result,s->text);
+	text_putc(s, (char)result);
 	return;
       }
       result = (result << 3) + (c - '0');
-      Delitem(s->text, DOH_END);
+      text_chop(s);
       break;
     case 20:
       if (!isxdigit(c)) {
 	retract(s,1);
-	Putc((char)result, s->text);
+	text_putc(s, (char)result);
 	return;
       }
       if (isdigit(c))
 	result = (result << 4) + (c - '0');
       else
 	result = (result << 4) + (10 + tolower(c) - 'a');
-      Delitem(s->text, DOH_END);
+      text_chop(s);
       break;
     }
   }
@@ -411,7 +512,7 @@ static int look(Scanner * s) {
   int c = 0;
 
   state = 0;
-  Clear(s->text);
+  s->tlen = 0;
   s->start_line = s->line;
   Setfile(s->text, Getfile(s->str));
   while (1) {
@@ -427,7 +528,7 @@ static int look(Scanner * s) {
       } else if (!isspace(c)) {
 	retract(s, 1);
 	state = 1000;
-	Clear(s->text);
+	s->tlen = 0;
 	Setline(s->text, s->line);
 	Setfile(s->text, Getfile(s->str));
       }
@@ -505,7 +606,7 @@ static int look(Scanner * s) {
       else if (c == '\"') {
 	state = 2;		/* Possibly a string */
 	s->start_line = s->line;
-	Clear(s->text);
+	s->tlen = 0;
       }
 
       else if (c == ':')
@@ -514,11 +615,11 @@ static int look(Scanner * s) {
 	state = 83;		/* An octal or hex value */
       else if (c == '\'') {
 	s->start_line = s->line;
-	Clear(s->text);
+	s->tlen = 0;
 	state = 9;		/* A character constant */
       } else if (c == '`') {
 	s->start_line = s->line;
-	Clear(s->text);
+	s->tlen = 0;
 	state = 900;
       }
 
@@ -535,16 +636,16 @@ static int look(Scanner * s) {
 	return (0);
       if (c == '/') {
 	state = 10;		/* C++ style comment */
-	Clear(s->text);
-	Setline(s->text, Getline(s->str));
+	s->tlen = 0;
+	Setline(s->text, s->str_line);
 	Setfile(s->text, Getfile(s->str));
-	Append(s->text, "//");
+	text_append(s, "//");
       } else if (c == '*') {
 	state = 11;		/* C style comment */
-	Clear(s->text);
-	Setline(s->text, Getline(s->str));
+	s->tlen = 0;
+	Setline(s->text, s->str_line);
 	Setfile(s->text, Getfile(s->str));
-	Append(s->text, "/*");
+	text_append(s, "/*");
       } else if (c == '=') {
 	return SWIG_TOKEN_DIVEQUAL;
       } else {
@@ -595,10 +696,10 @@ static int look(Scanner * s) {
 	return SWIG_TOKEN_ERROR;
       }
       if (c == '\"') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_STRING;
       } else if (c == '\\') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	get_escape(s);
       } else
 	state = 2;
@@ -657,8 +758,8 @@ static int look(Scanner * s) {
 	return SWIG_TOKEN_PERCENT;
       if (c == '{') {
 	state = 40;		/* Include block */
-	Clear(s->text);
-	Setline(s->text, Getline(s->str));
+	s->tlen = 0;
+	Setline(s->text, s->str_line);
 	Setfile(s->text, Getfile(s->str));
 	s->start_line = s->line;
       } else if (s->idstart && strchr(s->idstart, '%') &&
@@ -686,9 +787,8 @@ static int look(Scanner * s) {
 	return 0;
       }
       if (c == '}') {
-	Delitem(s->text, DOH_END);
-	Delitem(s->text, DOH_END);
-	Seek(s->text,0,SEEK_SET);
+	text_chop(s);
+	text_chop(s);
 	return SWIG_TOKEN_CODEBLOCK;
       } else {
 	state = 40;
@@ -755,9 +855,9 @@ static int look(Scanner * s) {
 
     case 71:			/* Identifier or true/false */
       if (cparse_cplusplus) {
-	if (Strcmp(s->text, "true") == 0)
+	if (s->tlen == 4 && strncmp(s->tbuf, "true", 4) == 0)
 	  return SWIG_TOKEN_BOOL;
-	else if (Strcmp(s->text, "false") == 0)
+	else if (s->tlen == 5 && strncmp(s->tbuf, "false", 5) == 0)
 	  return SWIG_TOKEN_BOOL;
 	}
       return SWIG_TOKEN_ID;
@@ -770,7 +870,7 @@ static int look(Scanner * s) {
 	state = 7;
       } else {
 	retract(s,1);
-	if (Len(s->text) == 1) return SWIG_TOKEN_DOLLAR;
+	if (s->tlen == 1) return SWIG_TOKEN_DOLLAR;
 	state = 71;
       }
       break;
@@ -783,7 +883,7 @@ static int look(Scanner * s) {
       } else if ((c == 'e') || (c == 'E')) {
 	state = 82;
       } else if ((c == 'f') || (c == 'F')) {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_FLOAT;
       } else if (isdigit(c)) {
 	state = 8;
@@ -804,10 +904,10 @@ static int look(Scanner * s) {
       else if ((c == 'e') || (c == 'E'))
 	state = 820;
       else if ((c == 'f') || (c == 'F')) {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_FLOAT;
       } else if ((c == 'l') || (c == 'L')) {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_DOUBLE;
       } else {
 	retract(s, 1);
@@ -897,10 +997,10 @@ static int look(Scanner * s) {
       if (isdigit(c))
 	state = 86;
       else if ((c == 'f') || (c == 'F')) {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_FLOAT;
       } else if ((c == 'l') || (c == 'L')) {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return SWIG_TOKEN_DOUBLE;
       } else {
 	retract(s, 1);
@@ -965,10 +1065,10 @@ static int look(Scanner * s) {
 	return SWIG_TOKEN_ERROR;
       }
       if (c == '\'') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return (SWIG_TOKEN_CHAR);
       } else if (c == '\\') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	get_escape(s);
       }
       break;
@@ -1080,7 +1180,7 @@ static int look(Scanner * s) {
 	return SWIG_TOKEN_ERROR;
       }
       if (c == '`') {
-	Delitem(s->text, DOH_END);
+	text_chop(s);
 	return (SWIG_TOKEN_RSTRING);
       }
       break;
@@ -1107,6 +1207,9 @@ int Scanner_token(Scanner * s) {
   }
   s->start_line = 0;
   t = look(s);
+  text_flush(s);
+  if (t == SWIG_TOKEN_CODEBLOCK)
+    (void)Seek(s->text, 0, SEEK_SET);
   if (!s->start_line) {
     Setline(s->text,s->line);
   } else {
@@ -1137,15 +1240,17 @@ void Scanner_skip_line(Scanner * s) {
   Clear(s->text);
   Setfile(s->text, Getfile(s->str));
   Setline(s->text, s->line);
+  s->tlen = 0;
   while (!done) {
     if ((c = nextchar(s)) == 0)
-      return;
+      break;
     if (c == '\\') {
       nextchar(s);
     } else if (c == '\n') {
       done = 1;
     }
   }
+  text_flush(s);
   return;
 }
 
@@ -1167,9 +1272,11 @@ int Scanner_skip_balanced(Scanner * s, int startchar, int endchar) {
   Setfile(s->text, Getfile(s->str));
   Setline(s->text, s->line);
 
-  Append(s->text, temp);
+  s->tlen = 0;
+  text_append(s, temp);
   while (num_levels > 0) {
     if ((c = nextchar(s)) == 0) {
+      text_flush(s);
       Delete(locator);
       return -1;
     }
@@ -1278,6 +1385,7 @@ int Scanner_skip_balanced(Scanner * s, int startchar, int endchar) {
       break;
     }
   }
+  text_flush(s);
   Delete(locator);
   return 0;
 }
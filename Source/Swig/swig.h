@@ -193,8 +193,10 @@ extern "C" {
   extern Typetab *SwigType_pop_scope(void);
   extern Typetab *SwigType_set_scope(Typetab *h);
   extern void SwigType_print_scope(void);
+  extern void SwigType_typedef_print_statistics(void);
   extern SwigType *SwigType_typedef_resolve(const SwigType *t);
   extern SwigType *SwigType_typedef_resolve_all(const SwigType *t);
+  extern int SwigType_typedef_cache_generation(void);
   extern SwigType *SwigType_typedef_qualified(const SwigType *t);
   extern int SwigType_istypedef(const SwigType *t);
   extern int SwigType_isclass(const SwigType *t);
@@ -212,6 +214,8 @@ extern "C" {
   extern void Swig_symbol_print_tables_summary(void);
   extern void Swig_symbol_print_symbols(void);
   extern void Swig_symbol_print_csymbols(void);
+  extern void Swig_symbol_print_statistics(void);
+  extern int Swig_symbol_lookup_generation(void);
   extern void Swig_symbol_init(void);
   extern void Swig_symbol_setscopename(const_String_or_char_ptr name);
   extern String *Swig_symbol_getscopename(void);
@@ -319,6 +323,12 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern String *Swig_string_upper(String *s);
   extern String *Swig_string_title(String *s);
   extern String *Swig_pcre_version(void);
+  extern int Swig_regex_exec(String *pattern, const char *input, int len, int *captures, int ncaptures, const char **errmsg, int *errpos);
+  extern void Swig_timing_enable(void);
+  extern void Swig_timing_phase(const char *name);
+  extern void Swig_timing_start(const char *name);
+  extern void Swig_timing_stop(const char *name);
+  extern void Swig_timing_report(FILE *f, int json);
   extern void Swig_init(void);
   extern int Swig_value_wrapper_mode(int mode);
   extern int Swig_is_generated_overload(Node *n);
@@ -331,6 +341,7 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_error_silent(int s);
   extern void Swig_warnfilter(const_String_or_char_ptr wlist, int val);
   extern void Swig_warnall(void);
+  extern String *Swig_warnfilter_get(void);
   extern int Swig_warn_count(void);
   extern void Swig_error_msg_format(ErrorMessageFormat format);
   extern void Swig_diagnostic(const_String_or_char_ptr filename, int line, const char *fmt, ...);
@@ -390,6 +401,7 @@ extern int        ParmList_is_compactdefargs(ParmList *p);
   extern void Swig_typemap_clear_apply(ParmList *pattern);
   extern void Swig_typemap_debug(void);
   extern void Swig_typemap_search_debug_set(void);
+  extern void Swig_typemap_search_debug_statistics(void);
   extern void Swig_typemap_used_debug_set(void);
   extern void Swig_typemap_register_debug_set(void);
 
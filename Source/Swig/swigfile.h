@@ -15,6 +15,8 @@ extern List   *Swig_add_directory(const_String_or_char_ptr dirname);
 extern void    Swig_push_directory(const_String_or_char_ptr dirname);
 extern void    Swig_pop_directory(void);
 extern String *Swig_last_file(void);
+extern List   *Swig_opened_files(void);
+extern List   *Swig_missing_files(void);
 extern List   *Swig_search_path(void);
 extern FILE   *Swig_include_open(const_String_or_char_ptr name);
 extern FILE   *Swig_open(const_String_or_char_ptr name);
@@ -31,6 +33,7 @@ extern String *Swig_file_basename(const_String_or_char_ptr filename);
 extern String *Swig_file_filename(const_String_or_char_ptr filename);
 extern String *Swig_file_dirname(const_String_or_char_ptr filename);
 extern void   Swig_file_debug_set();
+extern void   Swig_file_debug_statistics(void);
 
 /* Delimiter used in accessing files and directories */
 
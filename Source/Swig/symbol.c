@@ -176,6 +176,17 @@ static Hash *global_scope = 0;	/* Global scope */
 
 static int use_inherit = 1;
 
+/* Swig_symbol_clookup() results are cached per symbol table under "$lookupcache".
+   Any change to the symbol tables bumps lookup_cache_generation, which makes
+   all the caches stale ("$lookupgeneration" records the generation a cache
+   was filled in). Failed lookups are cached as lookup_cache_miss. */
+static int lookup_cache_generation = 0;
+static DOH *lookup_cache_miss = 0;
+static int lookup_cache_hits = 0;
+static int lookup_cache_negative_hits = 0;
+static int lookup_cache_misses = 0;
+static int lookup_cache_flushes = 0;
+
 /* common attribute keys, to avoid calling find_key all the times */
 
 
@@ -257,6 +268,65 @@ void Swig_symbol_print_csymbols(void) {
   Printf(stdout, "CSYMBOLS finish =======================================\n");
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_symbol_print_statistics()
+ *
+ * Display how effective the Swig_symbol_clookup() cache was
+ * ----------------------------------------------------------------------------- */
+
+void Swig_symbol_print_statistics(void) {
+  int hits = lookup_cache_hits + lookup_cache_negative_hits;
+  int lookups = hits + lookup_cache_misses;
+  Printf(stdout, "---[ symbol lookup cache ]---------------------------------------------------\n");
+  Printf(stdout, "Lookups         : %d\n", lookups);
+  Printf(stdout, "Cache hits      : %d (%d%%)\n", hits, lookups ? (int) (100.0 * hits / lookups) : 0);
+  Printf(stdout, "Negative hits   : %d\n", lookup_cache_negative_hits);
+  Printf(stdout, "Cache misses    : %d\n", lookup_cache_misses);
+  Printf(stdout, "Invalidations   : %d\n", lookup_cache_flushes);
+  Printf(stdout, "-----------------------------------------------------------------------------\n");
+}
+
+/* -----------------------------------------------------------------------------
+ * lookup_cache_invalidate()
+ *
+ * Called whenever a symbol table changes in a way that can affect lookups
+ * ----------------------------------------------------------------------------- */
+
+static void lookup_cache_invalidate(void) {
+  lookup_cache_generation++;
+  lookup_cache_flushes++;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_symbol_lookup_generation()
+ *
+ * Returns a number that changes whenever the C symbol tables change in a way
+ * that can affect lookups.  Lets other modules cache results derived from
+ * symbol lookups.
+ * ----------------------------------------------------------------------------- */
+
+int Swig_symbol_lookup_generation(void) {
+  return lookup_cache_generation;
+}
+
+/* -----------------------------------------------------------------------------
+ * lookup_cache_get()
+ *
+ * Returns the lookup cache of the given symbol table, emptying it first if it
+ * is stale.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *lookup_cache_get(Symtab *symtab) {
+  Hash *cache = Getattr(symtab, "$lookupcache");
+  if (!cache || GetInt(symtab, "$lookupgeneration") != lookup_cache_generation) {
+    cache = NewHash();
+    Setattr(symtab, "$lookupcache", cache);
+    Delete(cache);
+    SetInt(symtab, "$lookupgeneration", lookup_cache_generation);
+  }
+  return cache;
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_symbol_init()
  *
@@ -274,6 +344,8 @@ void Swig_symbol_init(void) {
   Setattr(current_symtab, "csymtab", ccurrent);
   Delete(ccurrent);
 
+  lookup_cache_miss = NewString("");
+
   /* Set the global scope */
   symtabs = NewHash();
   Setattr(symtabs, "", current_symtab);
@@ -289,6 +361,7 @@ void Swig_symbol_init(void) {
 
 void Swig_symbol_setscopename(const_String_or_char_ptr name) {
   String *qname;
+  lookup_cache_invalidate();
   /* assert(!Getattr(current_symtab,"name")); */
   Setattr(current_symtab, "name", name);
 
@@ -381,6 +454,7 @@ Symtab *Swig_symbol_newscope(void) {
   Hash *n;
   Hash *hsyms, *h;
 
+  lookup_cache_invalidate();
   hsyms = NewHash();
   h = NewHash();
 
@@ -430,6 +504,7 @@ Symtab *Swig_symbol_setscope(Symtab *sym) {
 
 Symtab *Swig_symbol_popscope(void) {
   Hash *h = current_symtab;
+  lookup_cache_invalidate();
   current_symtab = Getattr(current_symtab, "parentNode");
   assert(current_symtab);
   current = Getattr(current_symtab, "symtab");
@@ -468,6 +543,7 @@ Symtab *Swig_symbol_current(void) {
 
 void Swig_symbol_alias(const_String_or_char_ptr aliasname, Symtab *s) {
   String *qname = Swig_symbol_qualifiedscopename(current_symtab);
+  lookup_cache_invalidate();
   if (qname) {
     Printf(qname, "::%s", aliasname);
   } else {
@@ -507,6 +583,7 @@ void Swig_symbol_inherit(Symtab *s) {
     if (n == s)
       return;			/* Already inherited */
   }
+  lookup_cache_invalidate();
   Append(inherit, s);
 }
 
@@ -551,6 +628,7 @@ void Swig_symbol_cadd(const_String_or_char_ptr name, Node *n) {
 #ifdef SWIG_DEBUG
   Printf(stderr, "symbol_cadd %s %p\n", name, n);
 #endif
+  lookup_cache_invalidate();
   cn = Getattr(ccurrent, name);
 
   if (cn && (Getattr(cn, "sym:typename"))) {
@@ -1084,30 +1162,15 @@ static Node *symbol_lookup_qualified(const_String_or_char_ptr name, Symtab *symt
 }
 
 /* -----------------------------------------------------------------------------
- * Swig_symbol_clookup()
+ * symbol_clookup_scopes()
  *
- * Look up a symbol in the symbol table.   This uses the C name, not scripting
- * names.   Note: If we come across a using declaration, we follow it to
- * to get the real node. Any using directives are also followed (but this is
- * implemented in symbol_lookup()).
+ * Looks up a C symbol from symbol table hsym outwards, handling qualified names.
+ * This is the uncached part of Swig_symbol_clookup().
  * ----------------------------------------------------------------------------- */
 
-Node *Swig_symbol_clookup(const_String_or_char_ptr name, Symtab *n) {
-  Hash *hsym = 0;
+static Node *symbol_clookup_scopes(const_String_or_char_ptr name, Symtab *hsym) {
   Node *s = 0;
 
-  if (!n) {
-    hsym = current_symtab;
-  } else {
-    if (!Checkattr(n, "nodeType", "symboltable")) {
-      n = Getattr(n, "sym:symtab");
-    }
-    assert(n);
-    if (n) {
-      hsym = n;
-    }
-  }
-
   if (Swig_scopename_check(name)) {
     char *cname = Char(name);
     if (strncmp(cname, "::", 2) == 0) {
@@ -1139,6 +1202,55 @@ Node *Swig_symbol_clookup(const_String_or_char_ptr name, Symtab *n) {
 	break;
     }
   }
+  return s;
+}
+
+/* -----------------------------------------------------------------------------
+ * Swig_symbol_clookup()
+ *
+ * Look up a symbol in the symbol table.   This uses the C name, not scripting
+ * names.   Note: If we come across a using declaration, we follow it to
+ * to get the real node. Any using directives are also followed (but this is
+ * implemented in symbol_lookup()).
+ * ----------------------------------------------------------------------------- */
+
+Node *Swig_symbol_clookup(const_String_or_char_ptr name, Symtab *n) {
+  Hash *hsym = 0;
+  Hash *cache = 0;
+  Node *s = 0;
+
+  if (!n) {
+    hsym = current_symtab;
+  } else {
+    if (!Checkattr(n, "nodeType", "symboltable")) {
+      n = Getattr(n, "sym:symtab");
+    }
+    assert(n);
+    if (n) {
+      hsym = n;
+    }
+  }
+
+  if (use_inherit && hsym) {
+    cache = lookup_cache_get(hsym);
+    s = Getattr(cache, name);
+    if (s == lookup_cache_miss) {
+      lookup_cache_negative_hits++;
+      return 0;
+    }
+    if (s)
+      lookup_cache_hits++;
+  }
+
+  if (!s) {
+    int generation = lookup_cache_generation;
+    s = symbol_clookup_scopes(name, hsym);
+    if (cache) {
+      lookup_cache_misses++;
+      if (generation == lookup_cache_generation)
+	Setattr(cache, name, s ? s : lookup_cache_miss);
+    }
+  }
 
   if (!s) {
     return 0;
@@ -24,6 +24,13 @@ static int typemaps_used_debug = 0;
 static int typemap_register_debug = 0;
 static int in_typemap_search_multi = 0;
 
+/* Results of typemap_search(), keyed on method, type and names */
+static Hash *typemap_search_cache = 0;
+static int typemap_search_cache_generation = 0;
+static int typemap_search_cache_hits = 0;
+static int typemap_search_cache_misses = 0;
+static int typemap_search_cache_flushes = 0;
+
 static void replace_embedded_typemap(String *s, ParmList *parm_sublist, Wrapper *f, Node *file_line_node);
 
 /* -----------------------------------------------------------------------------
@@ -65,6 +72,21 @@ static void replace_embedded_typemap(String *s, ParmList *parm_sublist, Wrapper
 static Hash *typemaps[MAX_SCOPE];
 static int tm_scope = 0;
 
+/* -----------------------------------------------------------------------------
+ * typemap_search_cache_flush()
+ *
+ * Discards cached typemap_search() results.  Must be called whenever the
+ * typemaps change.
+ * ----------------------------------------------------------------------------- */
+
+static void typemap_search_cache_flush(void) {
+  if (typemap_search_cache) {
+    Delete(typemap_search_cache);
+    typemap_search_cache = 0;
+    typemap_search_cache_flushes++;
+  }
+}
+
 static Hash *get_typemap(int tm_scope, const SwigType *type) {
   Hash *tm = 0;
   SwigType *dtype = 0;
@@ -131,6 +153,7 @@ void Swig_typemap_init() {
   }
   typemaps[0] = NewHash();
   tm_scope = 0;
+  typemap_search_cache_flush();
 }
 
 static String *typemap_method_name(const_String_or_char_ptr tmap_method) {
@@ -203,6 +226,8 @@ static void typemap_register(const_String_or_char_ptr tmap_method, ParmList *par
   if (!parms)
     return;
 
+  typemap_search_cache_flush();
+
   if (typemap_register_debug) {
       Printf(stdout, "Registering - %s\n", tmap_method);
       Swig_print_node(parms);
@@ -405,6 +430,8 @@ void Swig_typemap_clear(const_String_or_char_ptr tmap_method, ParmList *parms) {
   String *multi_tmap_method;
   Hash *tm = 0;
 
+  typemap_search_cache_flush();
+
   /* This might not work */
   multi_tmap_method = NewString(tmap_method);
   p = parms;
@@ -459,6 +486,8 @@ int Swig_typemap_apply(ParmList *src, ParmList *dest) {
 
   /*  Printf(stdout,"apply : %s --> %s\n", ParmList_str(src), ParmList_str(dest)); */
 
+  typemap_search_cache_flush();
+
   /* Create type signature of source */
   ssig = NewStringEmpty();
   dsig = NewStringEmpty();
@@ -584,6 +613,8 @@ void Swig_typemap_clear_apply(Parm *parms) {
   Hash *tm;
   String *name;
 
+  typemap_search_cache_flush();
+
   /* Create a type signature of the parameters */
   tsig = NewStringEmpty();
   p = parms;
@@ -717,6 +748,8 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
   const String *cqualifiedname = 0;
   String *tm_method = typemap_method_name(tmap_method);
   int debug_display = (in_typemap_search_multi == 0) && typemap_search_debug;
+  String *cache_key;
+  Hash *cached;
 
   if ((name) && Len(name))
     cname = name;
@@ -724,6 +757,28 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
     cqualifiedname = qualifiedname;
   ts = tm_scope;
 
+  /* The search only depends on the typemaps and on typedef resolution, so the result can be reused until either changes */
+  if (typemap_search_cache_generation != SwigType_typedef_cache_generation()) {
+    typemap_search_cache_flush();
+    typemap_search_cache_generation = SwigType_typedef_cache_generation();
+  }
+  if (!typemap_search_cache)
+    typemap_search_cache = NewHash();
+  cache_key = NewStringf("%s\n%s\n%s\n%s", tm_method, type, cname ? cname : "", cqualifiedname ? cqualifiedname : "");
+  cached = Getattr(typemap_search_cache, cache_key);
+  if (cached) {
+    typemap_search_cache_hits++;
+    if (!debug_display) {
+      /* Repeat the search when debugging so that the search steps are still displayed */
+      Delete(cache_key);
+      if (matchtype)
+	*matchtype = Copy(Getattr(cached, "matchtype"));
+      return Getattr(cached, "typemap");
+    }
+  } else {
+    typemap_search_cache_misses++;
+  }
+
   if (debug_display) {
     String *typestr = SwigType_str(type, cqualifiedname ? cqualifiedname : cname);
     Swig_diagnostic(Getfile(node), Getline(node), "Searching for a suitable '%s' typemap for: %s\n", tmap_method, typestr);
@@ -810,6 +865,16 @@ static Hash *typemap_search(const_String_or_char_ptr tmap_method, SwigType *type
   result = backup;
 
 ret_result:
+  if (!cached) {
+    cached = NewHash();
+    if (result)
+      Setattr(cached, "typemap", result);
+    if (ctype)
+      Setattr(cached, "matchtype", ctype);
+    Setattr(typemap_search_cache, cache_key, cached);
+    Delete(cached);
+  }
+  Delete(cache_key);
   Delete(primitive);
   if (matchtype)
     *matchtype = Copy(ctype);
@@ -903,15 +968,38 @@ static int check_locals(ParmList *p, const char *s) {
   return 0;
 }
 
+/* Table of substitutions collected by typemap_replace_vars() and applied in one pass */
+typedef struct {
+  ReplaceItem *items;
+  int nitems;
+  int maxitems;
+  List *strings;		/* Keeps tokens and replacement text alive */
+} ReplaceTable;
+
+static int replace_table_add(ReplaceTable *t, const_String_or_char_ptr token, const_String_or_char_ptr rep, int flags) {
+  String *tok = NewString(token);
+  if (t->nitems == t->maxitems) {
+    t->maxitems = t->maxitems ? 2 * t->maxitems : 64;
+    t->items = (ReplaceItem *) realloc(t->items, t->maxitems * sizeof(ReplaceItem));
+  }
+  Append(t->strings, tok);
+  Delete(tok);
+  if (rep)
+    Append(t->strings, rep);
+  t->items[t->nitems].token = Char(tok);
+  t->items[t->nitems].rep = rep;
+  t->items[t->nitems].flags = flags;
+  t->items[t->nitems].count = 0;
+  return t->nitems++;
+}
+
 static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, SwigType *rtype, String *pname, String *lname, int index) {
   char var[512];
   char *varname;
   SwigType *ftype;
+  ReplaceTable table;
   int bare_substitution_count = 0;
-
-  Replaceall(s, "$typemap", "$TYPEMAP"); /* workaround for $type substitution below */
-
-  ftype = SwigType_typedef_resolve_all(type);
+  int i;
 
   if (!pname)
     pname = lname;
@@ -927,6 +1015,17 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
     if (!rep)
       locals = 0;
   }
+  if (!locals && !Strchr(s, '$'))
+    return 0;
+
+  table.items = 0;
+  table.nitems = 0;
+  table.maxitems = 0;
+  table.strings = NewList();
+
+  replace_table_add(&table, "$typemap", "$TYPEMAP", DOH_REPLACE_ANY); /* replace_embedded_typemap() looks for $TYPEMAP */
+
+  ftype = SwigType_typedef_resolve_all(type);
 
   sprintf(var, "$%d_", index);
   varname = &var[strlen(var)];
@@ -937,7 +1036,6 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
   if (SwigType_isarray(type) || SwigType_isarray(ftype)) {
     String *size;
     int ndim;
-    int i;
     if (SwigType_array_ndim(type) != SwigType_array_ndim(ftype))
       type = ftype;
     ndim = SwigType_array_ndim(type);
@@ -947,11 +1045,11 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
       if (index == 1) {
 	char t[32];
 	sprintf(t, "$dim%d", i);
-	Replace(s, t, dim, DOH_REPLACE_ANY);
+	replace_table_add(&table, t, dim, DOH_REPLACE_ANY);
 	replace_local_types(locals, t, dim);
       }
       sprintf(varname, "dim%d", i);
-      Replace(s, var, dim, DOH_REPLACE_ANY);
+      replace_table_add(&table, var, dim, DOH_REPLACE_ANY);
       replace_local_types(locals, var, dim);
       if (Len(size))
 	Putc('*', size);
@@ -959,25 +1057,28 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
       Delete(dim);
     }
     sprintf(varname, "size");
-    Replace(s, var, size, DOH_REPLACE_ANY);
+    replace_table_add(&table, var, size, DOH_REPLACE_ANY);
     replace_local_types(locals, var, size);
     Delete(size);
   }
 
   /* Parameter name substitution */
   if (index == 1) {
-    Replace(s, "$parmname", pname, DOH_REPLACE_ANY);
+    replace_table_add(&table, "$parmname", pname, DOH_REPLACE_ANY);
   }
   strcpy(varname, "name");
-  Replace(s, var, pname, DOH_REPLACE_ANY);
+  replace_table_add(&table, var, pname, DOH_REPLACE_ANY);
 
   /* Type-related stuff */
   {
-    SwigType *star_type, *amp_type, *base_type, *lex_type;
+    SwigType *star_type = 0, *amp_type, *base_type, *lex_type;
     SwigType *ltype, *star_ltype, *amp_ltype;
     String *mangle, *star_mangle, *amp_mangle, *base_mangle, *base_name, *base_type_str;
     String *descriptor, *star_descriptor, *amp_descriptor;
     String *ts;
+    int descriptor1 = -1, descriptor2 = -1;
+    int star_descriptor1 = -1, star_descriptor2 = -1;
+    int amp_descriptor1 = -1, amp_descriptor2 = -1;
     char *sc;
 
     sc = Char(s);
@@ -986,48 +1087,44 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
       /* Given type : $type */
       ts = SwigType_str(type, 0);
       if (index == 1) {
-	Replace(s, "$type", ts, DOH_REPLACE_ANY);
+	replace_table_add(&table, "$type", ts, DOH_REPLACE_ANY);
 	replace_local_types(locals, "$type", type);
       }
       strcpy(varname, "type");
-      Replace(s, var, ts, DOH_REPLACE_ANY);
+      replace_table_add(&table, var, ts, DOH_REPLACE_ANY);
       replace_local_types(locals, var, type);
       Delete(ts);
-      sc = Char(s);
     }
     if (strstr(sc, "ltype") || check_locals(locals, "ltype")) {
       /* Local type:  $ltype */
       ltype = SwigType_ltype(type);
       ts = SwigType_str(ltype, 0);
       if (index == 1) {
-	Replace(s, "$ltype", ts, DOH_REPLACE_ANY);
+	replace_table_add(&table, "$ltype", ts, DOH_REPLACE_ANY);
 	replace_local_types(locals, "$ltype", ltype);
       }
       strcpy(varname, "ltype");
-      Replace(s, var, ts, DOH_REPLACE_ANY);
+      replace_table_add(&table, var, ts, DOH_REPLACE_ANY);
       replace_local_types(locals, var, ltype);
       Delete(ts);
       Delete(ltype);
-      sc = Char(s);
     }
     if (strstr(sc, "mangle") || strstr(sc, "descriptor")) {
       /* Mangled type */
 
       mangle = SwigType_manglestr(type);
       if (index == 1)
-	Replace(s, "$mangle", mangle, DOH_REPLACE_ANY);
+	replace_table_add(&table, "$mangle", mangle, DOH_REPLACE_ANY);
       strcpy(varname, "mangle");
-      Replace(s, var, mangle, DOH_REPLACE_ANY);
+      replace_table_add(&table, var, mangle, DOH_REPLACE_ANY);
 
       descriptor = NewStringf("SWIGTYPE%s", mangle);
 
       if (index == 1)
-	if (Replace(s, "$descriptor", descriptor, DOH_REPLACE_ANY))
-	  SwigType_remember(type);
+	descriptor1 = replace_table_add(&table, "$descriptor", descriptor, DOH_REPLACE_ANY);
 
       strcpy(varname, "descriptor");
-      if (Replace(s, var, descriptor, DOH_REPLACE_ANY))
-	SwigType_remember(type);
+      descriptor2 = replace_table_add(&table, var, descriptor, DOH_REPLACE_ANY);
 
       Delete(descriptor);
       Delete(mangle);
@@ -1053,11 +1150,11 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
 	}
 	ts = SwigType_str(star_type, 0);
 	if (index == 1) {
-	  Replace(s, "$*type", ts, DOH_REPLACE_ANY);
+	  replace_table_add(&table, "$*type", ts, DOH_REPLACE_ANY);
 	  replace_local_types(locals, "$*type", star_type);
 	}
 	sprintf(varname, "$*%d_type", index);
-	Replace(s, varname, ts, DOH_REPLACE_ANY);
+	replace_table_add(&table, varname, ts, DOH_REPLACE_ANY);
 	replace_local_types(locals, varname, star_type);
 	Delete(ts);
       } else {
@@ -1066,33 +1163,30 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
       star_ltype = SwigType_ltype(star_type);
       ts = SwigType_str(star_ltype, 0);
       if (index == 1) {
-	Replace(s, "$*ltype", ts, DOH_REPLACE_ANY);
+	replace_table_add(&table, "$*ltype", ts, DOH_REPLACE_ANY);
 	replace_local_types(locals, "$*ltype", star_ltype);
       }
       sprintf(varname, "$*%d_ltype", index);
-      Replace(s, varname, ts, DOH_REPLACE_ANY);
+      replace_table_add(&table, varname, ts, DOH_REPLACE_ANY);
       replace_local_types(locals, varname, star_ltype);
       Delete(ts);
       Delete(star_ltype);
 
       star_mangle = SwigType_manglestr(star_type);
       if (index == 1)
-	Replace(s, "$*mangle", star_mangle, DOH_REPLACE_ANY);
+	replace_table_add(&table, "$*mangle", star_mangle, DOH_REPLACE_ANY);
 
       sprintf(varname, "$*%d_mangle", index);
-      Replace(s, varname, star_mangle, DOH_REPLACE_ANY);
+      replace_table_add(&table, varname, star_mangle, DOH_REPLACE_ANY);
 
       star_descriptor = NewStringf("SWIGTYPE%s", star_mangle);
       if (index == 1)
-	if (Replace(s, "$*descriptor", star_descriptor, DOH_REPLACE_ANY))
-	  SwigType_remember(star_type);
+	star_descriptor1 = replace_table_add(&table, "$*descriptor", star_descriptor, DOH_REPLACE_ANY);
       sprintf(varname, "$*%d_descriptor", index);
-      if (Replace(s, varname, star_descriptor, DOH_REPLACE_ANY))
-	SwigType_remember(star_type);
+      star_descriptor2 = replace_table_add(&table, varname, star_descriptor, DOH_REPLACE_ANY);
 
       Delete(star_descriptor);
       Delete(star_mangle);
-      Delete(star_type);
     } else {
       /* TODO: Signal error if one of the $* substitutions is
          requested */
@@ -1102,11 +1196,11 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
     SwigType_add_pointer(amp_type);
     ts = SwigType_str(amp_type, 0);
     if (index == 1) {
-      Replace(s, "$&type", ts, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$&type", ts, DOH_REPLACE_ANY);
       replace_local_types(locals, "$&type", amp_type);
     }
     sprintf(varname, "$&%d_type", index);
-    Replace(s, varname, ts, DOH_REPLACE_ANY);
+    replace_table_add(&table, varname, ts, DOH_REPLACE_ANY);
     replace_local_types(locals, varname, amp_type);
     Delete(ts);
 
@@ -1115,32 +1209,29 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
     ts = SwigType_str(amp_ltype, 0);
 
     if (index == 1) {
-      Replace(s, "$&ltype", ts, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$&ltype", ts, DOH_REPLACE_ANY);
       replace_local_types(locals, "$&ltype", amp_ltype);
     }
     sprintf(varname, "$&%d_ltype", index);
-    Replace(s, varname, ts, DOH_REPLACE_ANY);
+    replace_table_add(&table, varname, ts, DOH_REPLACE_ANY);
     replace_local_types(locals, varname, amp_ltype);
     Delete(ts);
     Delete(amp_ltype);
 
     amp_mangle = SwigType_manglestr(amp_type);
     if (index == 1)
-      Replace(s, "$&mangle", amp_mangle, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$&mangle", amp_mangle, DOH_REPLACE_ANY);
     sprintf(varname, "$&%d_mangle", index);
-    Replace(s, varname, amp_mangle, DOH_REPLACE_ANY);
+    replace_table_add(&table, varname, amp_mangle, DOH_REPLACE_ANY);
 
     amp_descriptor = NewStringf("SWIGTYPE%s", amp_mangle);
     if (index == 1)
-      if (Replace(s, "$&descriptor", amp_descriptor, DOH_REPLACE_ANY))
-	SwigType_remember(amp_type);
+      amp_descriptor1 = replace_table_add(&table, "$&descriptor", amp_descriptor, DOH_REPLACE_ANY);
     sprintf(varname, "$&%d_descriptor", index);
-    if (Replace(s, varname, amp_descriptor, DOH_REPLACE_ANY))
-      SwigType_remember(amp_type);
+    amp_descriptor2 = replace_table_add(&table, varname, amp_descriptor, DOH_REPLACE_ANY);
 
     Delete(amp_descriptor);
     Delete(amp_mangle);
-    Delete(amp_type);
 
     /* Base type */
     if (SwigType_isarray(type)) {
@@ -1153,18 +1244,18 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
     base_type_str = SwigType_str(base_type, 0);
     base_name = SwigType_namestr(base_type_str);
     if (index == 1) {
-      Replace(s, "$basetype", base_name, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$basetype", base_name, DOH_REPLACE_ANY);
       replace_local_types(locals, "$basetype", base_name);
     }
     strcpy(varname, "basetype");
-    Replace(s, var, base_type_str, DOH_REPLACE_ANY);
+    replace_table_add(&table, var, base_type_str, DOH_REPLACE_ANY);
     replace_local_types(locals, var, base_name);
 
     base_mangle = SwigType_manglestr(base_type);
     if (index == 1)
-      Replace(s, "$basemangle", base_mangle, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$basemangle", base_mangle, DOH_REPLACE_ANY);
     strcpy(varname, "basemangle");
-    Replace(s, var, base_mangle, DOH_REPLACE_ANY);
+    replace_table_add(&table, var, base_mangle, DOH_REPLACE_ANY);
     Delete(base_mangle);
     Delete(base_name);
     Delete(base_type_str);
@@ -1172,23 +1263,38 @@ static int typemap_replace_vars(String *s, ParmList *locals, SwigType *type, Swi
 
     lex_type = SwigType_base(rtype);
     if (index == 1)
-      Replace(s, "$lextype", lex_type, DOH_REPLACE_ANY);
+      replace_table_add(&table, "$lextype", lex_type, DOH_REPLACE_ANY);
     strcpy(varname, "lextype");
-    Replace(s, var, lex_type, DOH_REPLACE_ANY);
+    replace_table_add(&table, var, lex_type, DOH_REPLACE_ANY);
     Delete(lex_type);
-  }
 
-  /* Replace any $n. with (&n)-> */
-  {
-    char temp[64];
-    sprintf(var, "$%d.", index);
-    sprintf(temp, "(&$%d)->", index);
-    Replace(s, var, temp, DOH_REPLACE_ANY);
+    /* Replace any $n. with (&n)-> and the bare $n variable */
+    {
+      String *deref = NewStringf("(&%s)->", lname ? lname : "");
+      int dot, bare;
+      sprintf(var, "$%d.", index);
+      dot = replace_table_add(&table, var, deref, DOH_REPLACE_ANY);
+      sprintf(var, "$%d", index);
+      bare = replace_table_add(&table, var, lname, DOH_REPLACE_NUMBER_END);
+      Delete(deref);
+
+      /* All of the above are substituted in a single scan of the typemap code */
+      ReplaceMulti(s, table.items, table.nitems);
+      bare_substitution_count = table.items[dot].count + table.items[bare].count;
+    }
+
+    if ((descriptor1 >= 0 && table.items[descriptor1].count) || (descriptor2 >= 0 && table.items[descriptor2].count))
+      SwigType_remember(type);
+    if ((star_descriptor1 >= 0 && table.items[star_descriptor1].count) || (star_descriptor2 >= 0 && table.items[star_descriptor2].count))
+      SwigType_remember(star_type);
+    if ((amp_descriptor1 >= 0 && table.items[amp_descriptor1].count) || (amp_descriptor2 >= 0 && table.items[amp_descriptor2].count))
+      SwigType_remember(amp_type);
+    Delete(star_type);
+    Delete(amp_type);
   }
 
-  /* Replace the bare $n variable */
-  sprintf(var, "$%d", index);
-  bare_substitution_count = Replace(s, var, lname, DOH_REPLACE_NUMBER_END);
+  free(table.items);
+  Delete(table.strings);
   Delete(ftype);
   return bare_substitution_count;
 }
@@ -1543,13 +1649,21 @@ static String *Swig_typemap_lookup_impl(const_String_or_char_ptr tmap_method, No
 }
 
 String *Swig_typemap_lookup_out(const_String_or_char_ptr tmap_method, Node *node, const_String_or_char_ptr lname, Wrapper *f, String *actioncode) {
+  String *s;
   assert(actioncode);
   assert(Cmp(tmap_method, "out") == 0);
-  return Swig_typemap_lookup_impl(tmap_method, node, lname, f, actioncode);
+  Swig_timing_start("typemap lookup");
+  s = Swig_typemap_lookup_impl(tmap_method, node, lname, f, actioncode);
+  Swig_timing_stop("typemap lookup");
+  return s;
 }
 
 String *Swig_typemap_lookup(const_String_or_char_ptr tmap_method, Node *node, const_String_or_char_ptr lname, Wrapper *f) {
-  return Swig_typemap_lookup_impl(tmap_method, node, lname, f, 0);
+  String *s;
+  Swig_timing_start("typemap lookup");
+  s = Swig_typemap_lookup_impl(tmap_method, node, lname, f, 0);
+  Swig_timing_stop("typemap lookup");
+  return s;
 }
 
 /* -----------------------------------------------------------------------------
@@ -1643,6 +1757,7 @@ void Swig_typemap_attach_parms(const_String_or_char_ptr tmap_method, ParmList *p
   String *kwmatch = 0;
   p = parms;
 
+  Swig_timing_start("typemap lookup");
 #ifdef SWIG_DEBUG
   Printf(stdout, "Swig_typemap_attach_parms:  %s\n", tmap_method);
 #endif
@@ -1813,7 +1928,7 @@ void Swig_typemap_attach_parms(const_String_or_char_ptr tmap_method, ParmList *p
 #ifdef SWIG_DEBUG
   Printf(stdout, "Swig_typemap_attach_parms: end\n");
 #endif
-
+  Swig_timing_stop("typemap lookup");
 }
 
 /* Splits the arguments of an embedded typemap */
@@ -2078,6 +2193,22 @@ void Swig_typemap_search_debug_set(void) {
   typemap_search_debug = 1;
 }
 
+/* -----------------------------------------------------------------------------
+ * Swig_typemap_search_debug_statistics()
+ *
+ * Display how effective the typemap search cache was
+ * ----------------------------------------------------------------------------- */
+
+void Swig_typemap_search_debug_statistics(void) {
+  int searches = typemap_search_cache_hits + typemap_search_cache_misses;
+  Printf(stdout, "---[ typemap search cache ]--------------------------------------------------\n");
+  Printf(stdout, "Searches      : %d\n", searches);
+  Printf(stdout, "Cache hits    : %d (%d%%)\n", typemap_search_cache_hits, searches ? (int) (100.0 * typemap_search_cache_hits / searches) : 0);
+  Printf(stdout, "Cache misses  : %d\n", typemap_search_cache_misses);
+  Printf(stdout, "Cache flushes : %d\n", typemap_search_cache_flushes);
+  Printf(stdout, "-----------------------------------------------------------------------------\n");
+}
+
 /* -----------------------------------------------------------------------------
  * Swig_typemap_used_debug_set()
  *
@@ -131,10 +131,75 @@ int Swig_value_wrapper_mode(int mode) {
 }
 
 
+/* The results of the typedef resolution functions depend on the scope they are
+   looked up from, so each scope has its own caches ("$resolvecache", "$allcache"
+   and "$qualifiedcache"), and the static pointers above refer to the caches of
+   the current scope.  Changing scope keeps them; only changes to the type tables
+   bump typetab_generation, which makes the caches of all scopes stale
+   ("$cachegeneration" records the generation a scope's caches were filled in).
+   cache_generation also changes when the scope changes.  Qualified types also
+   depend on the symbol tables, so "$qualifiedgeneration" records the
+   Swig_symbol_lookup_generation() the scope's "$qualifiedcache" was filled in
+   and a different generation makes all its entries misses. */
+static int cache_generation = 0;
+static int qualified_cache_generation = 0;
+static int typetab_generation = 0;
+static int typedef_cache_hits = 0;
+static int typedef_cache_misses = 0;
+static int typedef_cache_flushes = 0;
+static int typedef_cache_scope_changes = 0;
+
+static void scope_changed() {
+  typedef_resolve_cache = 0;
+  typedef_all_cache = 0;
+  typedef_qualified_cache = 0;
+  cache_generation++;
+  typedef_cache_scope_changes++;
+}
+
 static void flush_cache() {
   typedef_resolve_cache = 0;
   typedef_all_cache = 0;
   typedef_qualified_cache = 0;
+  cache_generation++;
+  typetab_generation++;
+  typedef_cache_flushes++;
+}
+
+/* -----------------------------------------------------------------------------
+ * scope_cache()
+ *
+ * Returns the named cache of the current scope, emptying the scope's caches
+ * first if they are stale.
+ * ----------------------------------------------------------------------------- */
+
+static Hash *scope_cache(const char *name) {
+  Hash *cache;
+  if (GetInt(current_scope, "$cachegeneration") != typetab_generation) {
+    Delattr(current_scope, "$resolvecache");
+    Delattr(current_scope, "$allcache");
+    Delattr(current_scope, "$qualifiedcache");
+    SetInt(current_scope, "$cachegeneration", typetab_generation);
+  }
+  cache = Getattr(current_scope, name);
+  if (!cache) {
+    cache = NewHash();
+    Setattr(current_scope, name, cache);
+    Delete(cache);
+  }
+  return cache;
+}
+
+/* -----------------------------------------------------------------------------
+ * SwigType_typedef_cache_generation()
+ *
+ * Returns a number that changes whenever a typedef or scope change invalidates
+ * previously resolved types.  Lets other modules cache results derived from
+ * typedef resolution.
+ * ----------------------------------------------------------------------------- */
+
+int SwigType_typedef_cache_generation(void) {
+  return cache_generation;
 }
 
 /* Initialize the scoping system */
@@ -144,6 +209,7 @@ void SwigType_typesystem_init() {
     Delete(global_scope);
   if (scopes)
     Delete(scopes);
+  flush_cache();
 
   current_scope = NewHash();
   global_scope = current_scope;
@@ -285,6 +351,7 @@ void SwigType_inherit_scope(Typetab *scope) {
       return;
   }
   Append(inherits, scope);
+  flush_cache();
 }
 
 /* -----------------------------------------------------------------------------
@@ -349,7 +416,7 @@ Typetab *SwigType_pop_scope() {
   current_scope = t;
   current_typetab = Getattr(t, "typetab");
   current_symtab = Getattr(t, "symtab");
-  flush_cache();
+  scope_changed();
   return old;
 }
 
@@ -366,7 +433,7 @@ Typetab *SwigType_set_scope(Typetab *t) {
   current_scope = t;
   current_typetab = Getattr(t, "typetab");
   current_symtab = Getattr(t, "symtab");
-  flush_cache();
+  scope_changed();
   return old;
 }
 
@@ -379,6 +446,9 @@ Typetab *SwigType_set_scope(Typetab *t) {
 void SwigType_attach_symtab(Symtab *sym) {
   Setattr(current_scope, "symtab", sym);
   current_symtab = sym;
+  /* Qualified types found without the symbol table may differ */
+  Delattr(current_scope, "$qualifiedcache");
+  typedef_qualified_cache = 0;
 }
 
 /* -----------------------------------------------------------------------------
@@ -413,6 +483,23 @@ void SwigType_print_scope(void) {
   Printf(stdout, "SCOPES finish =======================================\n");
 }
 
+/* -----------------------------------------------------------------------------
+ * SwigType_typedef_print_statistics()
+ *
+ * Display how effective the typedef resolution caches were
+ * ----------------------------------------------------------------------------- */
+
+void SwigType_typedef_print_statistics(void) {
+  int lookups = typedef_cache_hits + typedef_cache_misses;
+  Printf(stdout, "---[ typedef resolution cache ]----------------------------------------------\n");
+  Printf(stdout, "Lookups         : %d\n", lookups);
+  Printf(stdout, "Cache hits      : %d (%d%%)\n", typedef_cache_hits, lookups ? (int) (100.0 * typedef_cache_hits / lookups) : 0);
+  Printf(stdout, "Cache misses    : %d\n", typedef_cache_misses);
+  Printf(stdout, "Invalidations   : %d\n", typedef_cache_flushes);
+  Printf(stdout, "Scope changes   : %d\n", typedef_cache_scope_changes);
+  Printf(stdout, "-----------------------------------------------------------------------------\n");
+}
+
 static Typetab *SwigType_find_scope(Typetab *s, const SwigType *nameprefix) {
   Typetab *ss;
   Typetab *s_orig = s;
@@ -609,13 +696,15 @@ SwigType *SwigType_typedef_resolve(const SwigType *t) {
 
 #ifdef SWIG_TYPEDEF_RESOLVE_CACHE
   if (!typedef_resolve_cache) {
-    typedef_resolve_cache = NewHash();
+    typedef_resolve_cache = scope_cache("$resolvecache");
   }
   r = Getattr(typedef_resolve_cache, t);
   if (r) {
+    typedef_cache_hits++;
     resolved_scope = Getmeta(r, "scope");
     return Copy(r);
   }
+  typedef_cache_misses++;
 #endif
 
   base = SwigType_base(t);
@@ -889,12 +978,14 @@ SwigType *SwigType_typedef_resolve_all(const SwigType *t) {
 
   /* Check to see if the typedef resolve has been done before by checking the cache */
   if (!typedef_all_cache) {
-    typedef_all_cache = NewHash();
+    typedef_all_cache = scope_cache("$allcache");
   }
   r = Getattr(typedef_all_cache, t);
   if (r) {
+    typedef_cache_hits++;
     return Copy(r);
   }
+  typedef_cache_misses++;
 
   /* Recursively resolve the typedef */
   r = NewString(t);
@@ -934,13 +1025,23 @@ SwigType *SwigType_typedef_qualified(const SwigType *t) {
   String *result;
   int i, len;
 
-  if (!typedef_qualified_cache)
-    typedef_qualified_cache = NewHash();
+  if (typedef_qualified_cache && qualified_cache_generation != Swig_symbol_lookup_generation())
+    typedef_qualified_cache = 0;
+  if (!typedef_qualified_cache) {
+    qualified_cache_generation = Swig_symbol_lookup_generation();
+    if (GetInt(current_scope, "$qualifiedgeneration") != qualified_cache_generation) {
+      Delattr(current_scope, "$qualifiedcache");
+      SetInt(current_scope, "$qualifiedgeneration", qualified_cache_generation);
+    }
+    typedef_qualified_cache = scope_cache("$qualifiedcache");
+  }
   result = Getattr(typedef_qualified_cache, t);
   if (result) {
     String *rc = Copy(result);
+    typedef_cache_hits++;
     return rc;
   }
+  typedef_cache_misses++;
 
   result = NewStringEmpty();
   elements = SwigType_split(t);
@@ -2036,6 +2137,7 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
     Hash *lthash;
     Iterator ltiter;
     Hash *nthash;
+    List *ntlist;
 
     cast_temp = NewStringEmpty();
 
@@ -2077,22 +2179,24 @@ void SwigType_emit_type_table(File *f_forward, File *f_table) {
       ltiter = Next(ltiter);
     }
 
-    /* now build nt */
-    ltiter = First(nthash);
+    /* now build nt, sorted so the output does not depend on the hash table */
+    ntlist = Keys(nthash);
+    SortList(ntlist, 0);
     nt = 0;
-    while (ltiter.key) {
+    for (ltiter = First(ntlist); ltiter.item; ltiter = Next(ltiter)) {
       if (nt) {
-	 Printf(nt, "|%s", ltiter.key);
+	 Printf(nt, "|%s", ltiter.item);
       } else {
-	 nt = NewString(ltiter.key);
+	 nt = NewString(ltiter.item);
       }
-      ltiter = Next(ltiter);
     }
+    Delete(ntlist);
     Delete(nthash);
 
     Printf(types, "\"%s\", \"%s\", 0, 0, (void*)%s, 0};\n", ki.item, nt, cd);
 
     el = SwigType_equivalent_mangle(ki.item, 0, 0);
+    SortList(el, SwigType_compare_mangled);
     for (ei = First(el); ei.item; ei = Next(ei)) {
       String *ckey;
       String *conv;
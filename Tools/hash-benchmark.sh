@@ -0,0 +1,26 @@
+#!/bin/sh
+
+# Compare the DOH Hash implementations (Source/DOH/hash.c) on real parse
+# trees.  swig -hash-benchmark parses an interface, copies out the attributes
+# of every parse tree node and then times building, looking up, iterating and
+# copying the same tables with the open addressing table used by SWIG and
+# with the chained table it replaced.  A few large interfaces from the
+# test-suite are used.
+#
+# Usage: Tools/hash-benchmark.sh [path to swig executable] [path to Lib] [language]
+# Run from the top level directory, by default it uses ./swig, ./Lib and python.
+
+swig=${1:-./swig}
+lib=${2:-./Lib}
+lang=${3:-python}
+testsuite=Examples/test-suite
+
+if test ! -x "$swig"; then
+    echo "$swig not found, build swig first or give its path as the first argument"
+    exit 1
+fi
+
+for i in li_boost_shared_ptr director_basic template_typedef_cplx2 li_std_vector_extra; do
+    echo "$i.i:"
+    SWIG_LIB="$lib" "$swig" -c++ -$lang -I$testsuite -hash-benchmark "$testsuite/$i.i" 2>/dev/null
+done
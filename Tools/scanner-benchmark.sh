@@ -0,0 +1,23 @@
+#!/bin/sh
+
+# Measure the throughput of the C/C++ scanner (Source/Swig/scanner.c) over the
+# SWIG library.  All the .i and .swg files under Lib are joined into one file,
+# which swig -scanner-benchmark splits into tokens repeatedly for about a
+# second before reporting MB/s and tokens/s.
+#
+# Usage: Tools/scanner-benchmark.sh [path to swig executable] [path to Lib]
+# Run from the top level directory, by default it uses ./swig and ./Lib.
+
+swig=${1:-./swig}
+lib=${2:-./Lib}
+
+if test ! -x "$swig"; then
+    echo "$swig not found, build swig first or give its path as the first argument"
+    exit 1
+fi
+
+input=${TMPDIR:-/tmp}/swig-scanner-benchmark-$$.i
+trap 'rm -f "$input"' 0 1 2 15
+
+find "$lib" \( -name '*.i' -o -name '*.swg' \) -type f | sort | xargs cat > "$input"
+SWIG_LIB="$lib" "$swig" -scanner-benchmark "$input"
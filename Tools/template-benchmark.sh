@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# Measure the cost of template instantiation.  A synthetic interface declaring
+# one class template with 30 or so members and instantiating it with %template
+# for 1000 different classes is generated and wrapped with -timing.  The
+# instantiation work is done while parsing, so compare the parse line between
+# runs; the other phases mostly measure the language module.
+#
+# Usage: Tools/template-benchmark.sh [path to swig executable] [path to Lib] [language]
+# Run from the top level directory, by default it uses ./swig, ./Lib and python.
+
+swig=${1:-./swig}
+lib=${2:-./Lib}
+lang=${3:-python}
+count=1000
+members=10
+
+if test ! -x "$swig"; then
+    echo "$swig not found, build swig first or give its path as the first argument"
+    exit 1
+fi
+
+dir=${TMPDIR:-/tmp}/swig-template-benchmark-$$
+trap 'rm -rf "$dir"' 0 1 2 15
+mkdir "$dir" || exit 1
+
+awk -v count=$count -v members=$members 'BEGIN {
+  print "%module template_benchmark"
+  print "template<class T> class Box {"
+  print "public:"
+  print "  Box();"
+  print "  Box(const T& v);"
+  print "  ~Box();"
+  for (i = 0; i < members; i++) {
+    print "  T get" i "() const;"
+    print "  void set" i "(const T& v);"
+    print "  const T* ptr" i "(int i, T* out = 0);"
+  }
+  print "};"
+  for (i = 0; i < count; i++) {
+    print "struct Item" i " { int value; };"
+    print "%template(Box" i ") Box<Item" i ">;"
+  }
+}' > "$dir/template_benchmark.i"
+
+SWIG_LIB="$lib" "$swig" -c++ -$lang -timing -outdir "$dir" -o "$dir/template_benchmark_wrap.cxx" "$dir/template_benchmark.i"